@@ -0,0 +1,233 @@
+/***********************************************************************
+*    datagrambufferpool.cpp:                                           *
+*    DatagramBufferPool, recycled fixed-size datagram payload storage  *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a source file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the implementation of a DatagramBufferPool class  *
+*    and of the DatagramBuffer handle it hands out                     *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <memory.h>
+
+#include "datagrambufferpool.h"
+
+constexpr size_t DatagramBufferPool::SLAB_BUFFER_COUNT;
+
+DatagramBuffer::DatagramBuffer() :
+    m_pool{nullptr},
+    m_sharedStorage{nullptr},
+    m_data{nullptr},
+    m_size{0},
+    m_capacity{0}
+{
+
+}
+
+DatagramBuffer::DatagramBuffer(size_t capacity) :
+    m_pool{nullptr},
+    m_sharedStorage{nullptr},
+    m_data{capacity > 0 ? new char[capacity] : nullptr},
+    m_size{0},
+    m_capacity{capacity}
+{
+
+}
+
+DatagramBuffer::DatagramBuffer(const char *data, size_t length) :
+    DatagramBuffer{length}
+{
+    if (length > 0) {
+        memcpy(this->m_data, data, length);
+    }
+    this->m_size = length;
+}
+
+DatagramBuffer::DatagramBuffer(std::shared_ptr<DatagramBufferPool> pool, char *data, size_t capacity) :
+    m_pool{std::move(pool)},
+    m_sharedStorage{nullptr},
+    m_data{data},
+    m_size{0},
+    m_capacity{capacity}
+{
+
+}
+
+DatagramBuffer::DatagramBuffer(DatagramBuffer &&other) noexcept :
+    m_pool{std::move(other.m_pool)},
+    m_sharedStorage{std::move(other.m_sharedStorage)},
+    m_data{other.m_data},
+    m_size{other.m_size},
+    m_capacity{other.m_capacity}
+{
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_capacity = 0;
+}
+
+DatagramBuffer &DatagramBuffer::operator=(DatagramBuffer &&other) noexcept
+{
+    if (this != &other) {
+        this->reset();
+        this->m_pool = std::move(other.m_pool);
+        this->m_sharedStorage = std::move(other.m_sharedStorage);
+        this->m_data = other.m_data;
+        this->m_size = other.m_size;
+        this->m_capacity = other.m_capacity;
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_capacity = 0;
+    }
+    return *this;
+}
+
+DatagramBuffer::~DatagramBuffer()
+{
+    this->reset();
+}
+
+void DatagramBuffer::setSize(size_t size)
+{
+    if (size > this->m_capacity) {
+        throw std::runtime_error("In DatagramBuffer::setSize(size_t): size is greater than the buffer capacity (" +
+                                 std::to_string(size)
+                                 + " > "
+                                 + std::to_string(this->m_capacity)
+                                 + ")");
+    }
+    this->m_size = size;
+}
+
+bool DatagramBuffer::isPooled() const
+{
+    return (this->m_sharedStorage ? this->m_sharedStorage->isPooled() : (this->m_pool != nullptr));
+}
+
+DatagramBuffer DatagramBuffer::slice(const std::shared_ptr<DatagramBuffer> &sharedStorage, size_t offset, size_t length)
+{
+    if ((!sharedStorage) || (offset + length > sharedStorage->size())) {
+        throw std::runtime_error("In DatagramBuffer::slice(const std::shared_ptr<DatagramBuffer> &, size_t, size_t): slice is outside of the shared storage");
+    }
+    DatagramBuffer slicedBuffer{};
+    slicedBuffer.m_sharedStorage = sharedStorage;
+    slicedBuffer.m_data = sharedStorage->m_data + offset;
+    slicedBuffer.m_size = length;
+    slicedBuffer.m_capacity = length;
+    return slicedBuffer;
+}
+
+DatagramBuffer DatagramBuffer::clone() const
+{
+    return DatagramBuffer{this->data(), this->m_size};
+}
+
+void DatagramBuffer::reset()
+{
+    if (!this->m_data) {
+        return;
+    }
+    if (this->m_sharedStorage) {
+        this->m_sharedStorage.reset();
+    } else if (this->m_pool) {
+        this->m_pool->release(this->m_data);
+        this->m_pool.reset();
+    } else {
+        delete[] this->m_data;
+    }
+    this->m_data = nullptr;
+    this->m_size = 0;
+    this->m_capacity = 0;
+}
+
+std::shared_ptr<DatagramBufferPool> DatagramBufferPool::create(size_t bufferSize, size_t maximumBufferCount)
+{
+    if ((bufferSize == 0) || (maximumBufferCount == 0)) {
+        throw std::runtime_error("In DatagramBufferPool::create(size_t, size_t): buffer size and maximum buffer count must be greater than 0");
+    }
+    return std::shared_ptr<DatagramBufferPool>{new DatagramBufferPool{bufferSize, maximumBufferCount}};
+}
+
+DatagramBufferPool::DatagramBufferPool(size_t bufferSize, size_t maximumBufferCount) :
+    m_bufferSize{bufferSize},
+    m_maximumBufferCount{maximumBufferCount},
+    m_slabs{},
+    m_freeBuffers{},
+    m_allocatedBufferCount{0},
+    m_buffersInUse{0},
+    m_highWaterMark{0},
+    m_exhaustionCount{0}
+{
+    //Reserve up front so recycling a buffer never reallocates the free list
+    this->m_freeBuffers.reserve(maximumBufferCount);
+    this->m_slabs.reserve((maximumBufferCount / DatagramBufferPool::SLAB_BUFFER_COUNT) + 1);
+}
+
+DatagramBuffer DatagramBufferPool::acquire()
+{
+    std::lock_guard<std::mutex> poolLock{this->m_poolMutex};
+    if (this->m_freeBuffers.empty()) {
+        if (this->m_allocatedBufferCount >= this->m_maximumBufferCount) {
+            return DatagramBuffer{};
+        }
+        size_t slabBufferCount{std::min(DatagramBufferPool::SLAB_BUFFER_COUNT, this->m_maximumBufferCount - this->m_allocatedBufferCount)};
+        std::unique_ptr<char[]> slab{new char[slabBufferCount * this->m_bufferSize]};
+        for (size_t i = 0; i < slabBufferCount; i++) {
+            this->m_freeBuffers.push_back(slab.get() + (i * this->m_bufferSize));
+        }
+        this->m_slabs.push_back(std::move(slab));
+        this->m_allocatedBufferCount += slabBufferCount;
+    }
+    char *data{this->m_freeBuffers.back()};
+    this->m_freeBuffers.pop_back();
+    this->m_buffersInUse++;
+    this->m_highWaterMark = std::max(this->m_highWaterMark, this->m_buffersInUse);
+    return DatagramBuffer{this->shared_from_this(), data, this->m_bufferSize};
+}
+
+void DatagramBufferPool::release(char *data)
+{
+    std::lock_guard<std::mutex> poolLock{this->m_poolMutex};
+    this->m_freeBuffers.push_back(data);
+    this->m_buffersInUse--;
+}
+
+void DatagramBufferPool::recordExhaustion()
+{
+    //Counted by the receiver when a datagram actually lands in heap storage, not on every failed acquire
+    std::lock_guard<std::mutex> poolLock{this->m_poolMutex};
+    this->m_exhaustionCount++;
+}
+
+size_t DatagramBufferPool::bufferSize() const
+{
+    return this->m_bufferSize;
+}
+
+size_t DatagramBufferPool::maximumBufferCount() const
+{
+    return this->m_maximumBufferCount;
+}
+
+DatagramBufferPoolStatistics DatagramBufferPool::statistics() const
+{
+    std::lock_guard<std::mutex> poolLock{this->m_poolMutex};
+    DatagramBufferPoolStatistics statistics{};
+    statistics.bufferSize = this->m_bufferSize;
+    statistics.maximumBufferCount = this->m_maximumBufferCount;
+    statistics.allocatedBufferCount = this->m_allocatedBufferCount;
+    statistics.buffersInUse = this->m_buffersInUse;
+    statistics.highWaterMark = this->m_highWaterMark;
+    statistics.exhaustionCount = this->m_exhaustionCount;
+    return statistics;
+}
@@ -0,0 +1,107 @@
+/***********************************************************************
+*    datagrambufferpool.h:                                             *
+*    DatagramBufferPool, recycled fixed-size datagram payload storage  *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a header file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the declarations of a DatagramBufferPool class    *
+*    and the move-only DatagramBuffer handle it hands out. A pooled    *
+*    handle gives its storage back to the pool when it is destroyed,   *
+*    so steady-state receives do not touch the heap. A handle may also *
+*    be a slice of shared storage, which is released with the last one *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#ifndef TJLUTILS_DATAGRAMBUFFERPOOL_H
+#define TJLUTILS_DATAGRAMBUFFERPOOL_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+
+class DatagramBufferPool;
+
+class DatagramBuffer
+{
+    friend class DatagramBufferPool;
+public:
+    DatagramBuffer();
+    explicit DatagramBuffer(size_t capacity);
+    DatagramBuffer(const char *data, size_t length);
+    DatagramBuffer(DatagramBuffer &&other) noexcept;
+    DatagramBuffer &operator=(DatagramBuffer &&other) noexcept;
+    DatagramBuffer(const DatagramBuffer &other) = delete;
+    DatagramBuffer &operator=(const DatagramBuffer &other) = delete;
+    ~DatagramBuffer();
+
+    char *data() { return this->m_data; }
+    const char *data() const { return (this->m_data ? this->m_data : ""); }
+    size_t size() const { return this->m_size; }
+    size_t capacity() const { return this->m_capacity; }
+    bool isNull() const { return this->m_data == nullptr; }
+    bool isPooled() const;
+    bool isSlice() const { return this->m_sharedStorage != nullptr; }
+    void setSize(size_t size);
+    DatagramBuffer clone() const;
+    void reset();
+
+    static DatagramBuffer slice(const std::shared_ptr<DatagramBuffer> &sharedStorage, size_t offset, size_t length);
+
+private:
+    DatagramBuffer(std::shared_ptr<DatagramBufferPool> pool, char *data, size_t capacity);
+
+    std::shared_ptr<DatagramBufferPool> m_pool;
+    std::shared_ptr<DatagramBuffer> m_sharedStorage;
+    char *m_data;
+    size_t m_size;
+    size_t m_capacity;
+};
+
+struct DatagramBufferPoolStatistics
+{
+    size_t bufferSize;
+    size_t maximumBufferCount;
+    size_t allocatedBufferCount;
+    size_t buffersInUse;
+    size_t highWaterMark;
+    size_t exhaustionCount;
+};
+
+class DatagramBufferPool : public std::enable_shared_from_this<DatagramBufferPool>
+{
+    friend class DatagramBuffer;
+public:
+    static std::shared_ptr<DatagramBufferPool> create(size_t bufferSize, size_t maximumBufferCount);
+
+    DatagramBuffer acquire();
+    void recordExhaustion();
+    size_t bufferSize() const;
+    size_t maximumBufferCount() const;
+    DatagramBufferPoolStatistics statistics() const;
+
+    static const constexpr size_t SLAB_BUFFER_COUNT{16};
+
+private:
+    DatagramBufferPool(size_t bufferSize, size_t maximumBufferCount);
+    void release(char *data);
+
+    const size_t m_bufferSize;
+    const size_t m_maximumBufferCount;
+    mutable std::mutex m_poolMutex;
+    std::vector<std::unique_ptr<char[]>> m_slabs;
+    std::vector<char *> m_freeBuffers;
+    size_t m_allocatedBufferCount;
+    size_t m_buffersInUse;
+    size_t m_highWaterMark;
+    size_t m_exhaustionCount;
+};
+
+#endif //TJLUTILS_DATAGRAMBUFFERPOOL_H
@@ -0,0 +1,186 @@
+/***********************************************************************
+*    delimitersearch.cpp:                                              *
+*    findDelimiter, a vectorized search for multi-byte delimiters      *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a source file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the implementation of the delimiter search        *
+*    functions                                                         *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#include "delimitersearch.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+    #define TJLUTILS_DELIMITER_SEARCH_X86 1
+    #include <immintrin.h>
+#endif
+
+using DelimiterSearch = size_t (*)(const char *, size_t, const char *, size_t);
+
+size_t findDelimiterScalar(const char *data, size_t length, const char *delimiter, size_t delimiterLength)
+{
+    if ((delimiterLength == 0) || (length < delimiterLength)) {
+        return length;
+    }
+    const char *searchEnd{data + length - delimiterLength + 1};
+    for (const char *candidate = data; candidate < searchEnd; candidate++) {
+        candidate = static_cast<const char *>(memchr(candidate, delimiter[0], static_cast<size_t>(searchEnd - candidate)));
+        if (!candidate) {
+            break;
+        }
+        if (memcmp(candidate, delimiter, delimiterLength) == 0) {
+            return static_cast<size_t>(candidate - data);
+        }
+    }
+    return length;
+}
+
+#if defined(TJLUTILS_DELIMITER_SEARCH_X86)
+
+//Checks every candidate start in the mask against the whole delimiter, lowest position first
+static size_t matchCandidates(const char *data, size_t position, uint64_t candidates, const char *delimiter, size_t delimiterLength)
+{
+    while (candidates != 0) {
+        size_t candidate{position + static_cast<size_t>(__builtin_ctzll(candidates))};
+        if (memcmp(data + candidate, delimiter, delimiterLength) == 0) {
+            return candidate;
+        }
+        candidates &= (candidates - 1);
+    }
+    return SIZE_MAX;
+}
+
+//A bit is set wherever both the first and the last byte of the delimiter line up, only those are compared in full
+static uint64_t candidatesSSE2(const char *data, size_t position, size_t delimiterLength, __m128i firstByte, __m128i lastByte)
+{
+    __m128i firstBlock{_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + position))};
+    __m128i lastBlock{_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + position + delimiterLength - 1))};
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(firstBlock, firstByte), _mm_cmpeq_epi8(lastBlock, lastByte))));
+}
+
+static size_t findDelimiterSSE2(const char *data, size_t length, const char *delimiter, size_t delimiterLength)
+{
+    if ((delimiterLength == 0) || (length < delimiterLength)) {
+        return length;
+    }
+    const size_t startCount{length - delimiterLength + 1};
+    if (startCount < 16) {
+        return findDelimiterScalar(data, length, delimiter, delimiterLength);
+    }
+    const __m128i firstByte{_mm_set1_epi8(delimiter[0])};
+    const __m128i lastByte{_mm_set1_epi8(delimiter[delimiterLength - 1])};
+    size_t position{0};
+    for (; position + 16 <= startCount; position += 16) {
+        size_t match{matchCandidates(data, position, candidatesSSE2(data, position, delimiterLength, firstByte, lastByte), delimiter, delimiterLength)};
+        if (match != SIZE_MAX) {
+            return match;
+        }
+    }
+    if (position < startCount) {
+        //The last block overlaps the one before it instead of falling back to a scalar tail
+        size_t lastPosition{startCount - 16};
+        size_t match{matchCandidates(data, lastPosition, candidatesSSE2(data, lastPosition, delimiterLength, firstByte, lastByte) >> (position - lastPosition) << (position - lastPosition), delimiter, delimiterLength)};
+        if (match != SIZE_MAX) {
+            return match;
+        }
+    }
+    return length;
+}
+
+__attribute__((target("avx2")))
+static inline __m256i matchesAVX2(const char *data, size_t position, size_t delimiterLength, __m256i firstByte, __m256i lastByte)
+{
+    __m256i firstBlock{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + position))};
+    __m256i lastBlock{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + position + delimiterLength - 1))};
+    return _mm256_and_si256(_mm256_cmpeq_epi8(firstBlock, firstByte), _mm256_cmpeq_epi8(lastBlock, lastByte));
+}
+
+__attribute__((target("avx2")))
+static size_t findDelimiterAVX2(const char *data, size_t length, const char *delimiter, size_t delimiterLength)
+{
+    if ((delimiterLength == 0) || (length < delimiterLength)) {
+        return length;
+    }
+    const size_t startCount{length - delimiterLength + 1};
+    if (startCount < 32) {
+        return findDelimiterSSE2(data, length, delimiter, delimiterLength);
+    }
+    const __m256i firstByte{_mm256_set1_epi8(delimiter[0])};
+    const __m256i lastByte{_mm256_set1_epi8(delimiter[delimiterLength - 1])};
+    size_t position{0};
+    //Two blocks per pass, and the masks are only extracted when either of them has a candidate
+    for (; position + 64 <= startCount; position += 64) {
+        __m256i lowMatches{matchesAVX2(data, position, delimiterLength, firstByte, lastByte)};
+        __m256i highMatches{matchesAVX2(data, position + 32, delimiterLength, firstByte, lastByte)};
+        __m256i anyMatches{_mm256_or_si256(lowMatches, highMatches)};
+        if (_mm256_testz_si256(anyMatches, anyMatches)) {
+            continue;
+        }
+        uint64_t candidates{static_cast<uint32_t>(_mm256_movemask_epi8(lowMatches)) |
+                            (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(highMatches))) << 32)};
+        size_t match{matchCandidates(data, position, candidates, delimiter, delimiterLength)};
+        if (match != SIZE_MAX) {
+            return match;
+        }
+    }
+    for (; position + 32 <= startCount; position += 32) {
+        size_t match{matchCandidates(data, position, static_cast<uint32_t>(_mm256_movemask_epi8(matchesAVX2(data, position, delimiterLength, firstByte, lastByte))), delimiter, delimiterLength)};
+        if (match != SIZE_MAX) {
+            return match;
+        }
+    }
+    if (position < startCount) {
+        size_t lastPosition{startCount - 32};
+        uint64_t candidates{static_cast<uint32_t>(_mm256_movemask_epi8(matchesAVX2(data, lastPosition, delimiterLength, firstByte, lastByte)))};
+        size_t match{matchCandidates(data, lastPosition, candidates >> (position - lastPosition) << (position - lastPosition), delimiter, delimiterLength)};
+        if (match != SIZE_MAX) {
+            return match;
+        }
+    }
+    return length;
+}
+
+#endif
+
+static DelimiterSearch selectDelimiterSearch()
+{
+#if defined(TJLUTILS_DELIMITER_SEARCH_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return findDelimiterAVX2;
+    }
+    return findDelimiterSSE2;
+#else
+    return findDelimiterScalar;
+#endif
+}
+
+size_t findDelimiter(const char *data, size_t length, const char *delimiter, size_t delimiterLength)
+{
+    static const DelimiterSearch delimiterSearch{selectDelimiterSearch()};
+    return delimiterSearch(data, length, delimiter, delimiterLength);
+}
+
+const char *delimiterSearchInstructionSet()
+{
+#if defined(TJLUTILS_DELIMITER_SEARCH_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return "AVX2";
+    }
+    return "SSE2";
+#else
+    return "Scalar";
+#endif
+}
@@ -0,0 +1,35 @@
+/***********************************************************************
+*    delimitersearch.h:                                                *
+*    findDelimiter, a vectorized search for multi-byte delimiters      *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a header file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the declarations of the delimiter search          *
+*    functions. On x86 the first and last byte of the delimiter are    *
+*    compared against 16 (SSE2) or 32 (AVX2) positions at once, and    *
+*    only the positions where both match are checked in full. The      *
+*    widest instruction set the CPU supports is picked at run time,    *
+*    and other targets use a memchr based scalar search                *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#ifndef TJLUTILS_DELIMITERSEARCH_H
+#define TJLUTILS_DELIMITERSEARCH_H
+
+#include <cstddef>
+
+/*Both return the offset of the first delimiter in data, or length when there is none (or the delimiter is empty)*/
+size_t findDelimiter(const char *data, size_t length, const char *delimiter, size_t delimiterLength);
+size_t findDelimiterScalar(const char *data, size_t length, const char *delimiter, size_t delimiterLength);
+
+/*"AVX2", "SSE2" or "Scalar", whichever findDelimiter() dispatches to on this CPU*/
+const char *delimiterSearchInstructionSet();
+
+#endif //TJLUTILS_DELIMITERSEARCH_H
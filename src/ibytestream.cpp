@@ -478,6 +478,19 @@ void IByteStreamScriptExecutor::setScriptFilePath(const std::string &iByteStream
     this->m_iByteStreamScriptReader = std::make_shared<IByteStreamScriptReader>(iByteStreamScriptFilePath);
 }
 
+std::vector<std::string> IByteStreamScriptExecutor::collectWriteBatch(size_t *commandIndex) const
+{
+    //Consecutive writes go out together, leaving the index on the last write of the run
+    std::vector<std::string> writeArguments{};
+    size_t writeIndex{*commandIndex};
+    while ((writeIndex < this->m_iByteStreamScriptCommands.size()) && (this->m_iByteStreamScriptCommands[writeIndex].commandType() == IByteStreamCommandType::WRITE)) {
+        writeArguments.push_back(this->m_iByteStreamScriptCommands[writeIndex].commandArgument());
+        writeIndex++;
+    }
+    *commandIndex = writeIndex - 1;
+    return writeArguments;
+}
+
 std::vector<IByteStreamCommand> IByteStreamScriptExecutor::doUnrollLoopCommands(const std::vector<IByteStreamCommand> &IByteStreamCommands)
 {
     std::vector<IByteStreamCommand> copyCommands{IByteStreamCommands};
@@ -69,6 +69,16 @@ public:
 
     virtual ssize_t writeLine(const std::string &str) = 0;
     virtual ssize_t writeLine(const char *str) = 0;
+    //Streams that can submit several lines at once override this, the default is one writeLine() per line
+    virtual std::vector<ssize_t> writeBatch(const std::vector<std::string> &lines)
+    {
+        std::vector<ssize_t> results{};
+        results.reserve(lines.size());
+        for (auto &it : lines) {
+            results.push_back(this->writeLine(it));
+        }
+        return results;
+    }
     virtual ssize_t available() = 0;
     virtual bool isOpen() const = 0;
     virtual void openPort() = 0;
@@ -183,11 +193,15 @@ public:
         int loop {false};
         int loopCount{0};
         this->m_iByteStreamScriptCommands = doUnrollLoopCommands(*this->m_iByteStreamScriptReader->commands());
-        for (auto &it : this->m_iByteStreamScriptCommands) {
+        for (size_t i = 0; i < this->m_iByteStreamScriptCommands.size(); i++) {
+            auto &it = this->m_iByteStreamScriptCommands[i];
             try {
                 if (it.commandType() == IByteStreamCommandType::WRITE) {
-                    ioStream->writeLine(it.commandArgument());
-                    printTxResult(it.commandArgument());
+                    std::vector<std::string> writeArguments{this->collectWriteBatch(&i)};
+                    ioStream->writeBatch(writeArguments);
+                    for (auto &writeArgument : writeArguments) {
+                        printTxResult(writeArgument);
+                    }
                 } else if (it.commandType() == IByteStreamCommandType::READ) {
                     printRxResult(ioStream->readLine());
                 } else if (it.commandType() == IByteStreamCommandType::DELAY_SECONDS) {
@@ -243,11 +257,15 @@ public:
         this->m_iByteStreamScriptCommands = doUnrollLoopCommands(*this->m_iByteStreamScriptReader->commands());
         (void)loop;
         (void)loopCount;
-        for (auto &it : this->m_iByteStreamScriptCommands) {
+        for (size_t i = 0; i < this->m_iByteStreamScriptCommands.size(); i++) {
+            auto &it = this->m_iByteStreamScriptCommands[i];
             try {
                 if (it.commandType() == IByteStreamCommandType::WRITE) {
-                    ioStream->writeLine(it.commandArgument());
-                    printTxResult(instanceArg, it.commandArgument());
+                    std::vector<std::string> writeArguments{this->collectWriteBatch(&i)};
+                    ioStream->writeBatch(writeArguments);
+                    for (auto &writeArgument : writeArguments) {
+                        printTxResult(instanceArg, writeArgument);
+                    }
                 } else if (it.commandType() == IByteStreamCommandType::READ) {
                     printRxResult(instanceArg, ioStream->readLine());
                 } else if (it.commandType() == IByteStreamCommandType::DELAY_SECONDS) {
@@ -281,6 +299,7 @@ private:
     std::vector<IByteStreamCommand> m_iByteStreamScriptCommands;
 
     std::vector<IByteStreamCommand> doUnrollLoopCommands(const std::vector<IByteStreamCommand> &iByteStreamCommands);
+    std::vector<std::string> collectWriteBatch(size_t *commandIndex) const;
     bool containsLoopStart(const std::vector<IByteStreamCommand> &commands);
     std::pair<int, int> findInnerLoopIndexes(const std::vector<IByteStreamCommand> &iByteStreamCommands);
 };
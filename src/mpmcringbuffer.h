@@ -0,0 +1,140 @@
+/***********************************************************************
+*    mpmcringbuffer.h:                                                 *
+*    MPMCRingBuffer, bounded multi-producer/multi-consumer queue       *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a header file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the declaration and implementation of a lock-free *
+*    ring buffer, with a power-of-two capacity, that any number of     *
+*    threads may push to and pop from. Every slot carries a sequence   *
+*    number, so producers and consumers claim slots with a single      *
+*    compare-and-swap on their own position counter                    *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#ifndef TJLUTILS_MPMCRINGBUFFER_H
+#define TJLUTILS_MPMCRINGBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+template <typename T>
+class MPMCRingBuffer
+{
+public:
+    explicit MPMCRingBuffer(size_t capacity) :
+        m_mask{roundUpToPowerOfTwo(capacity) - 1},
+        m_cells{new Cell[m_mask + 1]},
+        m_enqueuePosition{0},
+        m_dequeuePosition{0}
+    {
+        for (size_t i = 0; i <= this->m_mask; i++) {
+            this->m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCRingBuffer(const MPMCRingBuffer &) = delete;
+    MPMCRingBuffer &operator=(const MPMCRingBuffer &) = delete;
+
+    /*The item is only moved from when the push succeeds*/
+    bool tryPush(T &&item)
+    {
+        size_t position{this->m_enqueuePosition.load(std::memory_order_relaxed)};
+        while (true) {
+            Cell &cell = this->m_cells[position & this->m_mask];
+            size_t sequence{cell.sequence.load(std::memory_order_acquire)};
+            intptr_t difference{static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position)};
+            if (difference == 0) {
+                if (this->m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.item = std::move(item);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = this->m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(T &item)
+    {
+        size_t position{this->m_dequeuePosition.load(std::memory_order_relaxed)};
+        while (true) {
+            Cell &cell = this->m_cells[position & this->m_mask];
+            size_t sequence{cell.sequence.load(std::memory_order_acquire)};
+            intptr_t difference{static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1)};
+            if (difference == 0) {
+                if (this->m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    item = std::move(cell.item);
+                    //Release whatever the slot owns now instead of when it is next overwritten
+                    cell.item = T{};
+                    cell.sequence.store(position + this->m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = this->m_dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /*Approximate while other threads are pushing or popping*/
+    size_t size() const
+    {
+        size_t dequeuePosition{this->m_dequeuePosition.load(std::memory_order_acquire)};
+        size_t enqueuePosition{this->m_enqueuePosition.load(std::memory_order_acquire)};
+        return (enqueuePosition > dequeuePosition ? enqueuePosition - dequeuePosition : 0);
+    }
+
+    bool empty() const { return this->size() == 0; }
+    size_t capacity() const { return this->m_mask + 1; }
+
+    static const constexpr size_t CACHE_LINE_SIZE{64};
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    const size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    char m_cellsPadding[CACHE_LINE_SIZE];
+
+    /*Producer owned cache line*/
+    std::atomic<size_t> m_enqueuePosition;
+    char m_producerPadding[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+
+    /*Consumer owned cache line*/
+    std::atomic<size_t> m_dequeuePosition;
+    char m_consumerPadding[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+
+    static size_t roundUpToPowerOfTwo(size_t capacity)
+    {
+        if (capacity == 0) {
+            throw std::runtime_error("In MPMCRingBuffer::roundUpToPowerOfTwo(size_t): capacity must be greater than 0");
+        }
+        size_t powerOfTwo{1};
+        while (powerOfTwo < capacity) {
+            powerOfTwo <<= 1;
+        }
+        return powerOfTwo;
+    }
+};
+
+#endif //TJLUTILS_MPMCRINGBUFFER_H
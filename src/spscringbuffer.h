@@ -0,0 +1,147 @@
+/***********************************************************************
+*    spscringbuffer.h:                                                 *
+*    SPSCRingBuffer, bounded single-producer/single-consumer queue     *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a header file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the declaration and implementation of a lock-free *
+*    ring buffer, with a power-of-two capacity, that may be pushed to  *
+*    from exactly one thread and popped from exactly one other thread  *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#ifndef TJLUTILS_SPSCRINGBUFFER_H
+#define TJLUTILS_SPSCRINGBUFFER_H
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+template <typename T>
+class SPSCRingBuffer
+{
+public:
+    explicit SPSCRingBuffer(size_t capacity) :
+        m_head{0},
+        m_cachedTail{0},
+        m_tail{0},
+        m_cachedHead{0},
+        m_mask{roundUpToPowerOfTwo(capacity) - 1},
+        m_buffer{new T[m_mask + 1]}
+    {
+
+    }
+
+    SPSCRingBuffer(const SPSCRingBuffer &) = delete;
+    SPSCRingBuffer &operator=(const SPSCRingBuffer &) = delete;
+
+    /*Producer side*/
+    bool tryPush(T &&item)
+    {
+        size_t tail{this->m_tail.load(std::memory_order_relaxed)};
+        if (tail - this->m_cachedHead > this->m_mask) {
+            this->m_cachedHead = this->m_head.load(std::memory_order_acquire);
+            if (tail - this->m_cachedHead > this->m_mask) {
+                return false;
+            }
+        }
+        this->m_buffer[tail & this->m_mask] = std::move(item);
+        this->m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPush(const T &item)
+    {
+        T copy{item};
+        return this->tryPush(std::move(copy));
+    }
+
+    /*Consumer side*/
+    T *front()
+    {
+        size_t head{this->m_head.load(std::memory_order_relaxed)};
+        if (head == this->m_cachedTail) {
+            this->m_cachedTail = this->m_tail.load(std::memory_order_acquire);
+            if (head == this->m_cachedTail) {
+                return nullptr;
+            }
+        }
+        return &this->m_buffer[head & this->m_mask];
+    }
+
+    bool tryPop(T &item)
+    {
+        T *frontItem{this->front()};
+        if (!frontItem) {
+            return false;
+        }
+        item = std::move(*frontItem);
+        this->pop();
+        return true;
+    }
+
+    void pop()
+    {
+        size_t head{this->m_head.load(std::memory_order_relaxed)};
+        //Release whatever the slot owns now instead of when it is next overwritten
+        this->m_buffer[head & this->m_mask] = T{};
+        this->m_head.store(head + 1, std::memory_order_release);
+    }
+
+    void clear()
+    {
+        while (this->front()) {
+            this->pop();
+        }
+    }
+
+    /*Either side, exact only when called from the consumer with the producer idle*/
+    size_t size() const
+    {
+        size_t head{this->m_head.load(std::memory_order_acquire)};
+        size_t tail{this->m_tail.load(std::memory_order_acquire)};
+        return tail - head;
+    }
+
+    bool empty() const { return this->size() == 0; }
+    size_t capacity() const { return this->m_mask + 1; }
+
+    static const constexpr size_t CACHE_LINE_SIZE{64};
+
+private:
+    /*Consumer owned cache line*/
+    std::atomic<size_t> m_head;
+    size_t m_cachedTail;
+    char m_consumerPadding[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+
+    /*Producer owned cache line*/
+    std::atomic<size_t> m_tail;
+    size_t m_cachedHead;
+    char m_producerPadding[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+
+    const size_t m_mask;
+    std::unique_ptr<T[]> m_buffer;
+
+    static size_t roundUpToPowerOfTwo(size_t capacity)
+    {
+        if (capacity == 0) {
+            throw std::runtime_error("In SPSCRingBuffer::roundUpToPowerOfTwo(size_t): capacity must be greater than 0");
+        }
+        size_t powerOfTwo{1};
+        while (powerOfTwo < capacity) {
+            powerOfTwo <<= 1;
+        }
+        return powerOfTwo;
+    }
+};
+
+#endif //TJLUTILS_SPSCRINGBUFFER_H
@@ -0,0 +1,79 @@
+#include <iostream>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <udpduplex.h>
+#include <spscringbuffer.h>
+
+static const size_t DATAGRAM_COUNT{5000000};
+static const size_t RING_BUFFER_CAPACITY{UDPServer::DEFAULT_RING_BUFFER_CAPACITY};
+
+static UDPDatagram makeDatagram(size_t index)
+{
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(index));
+    return UDPDatagram{address, "{dwrite:2:0:1}"};
+}
+
+double benchmarkDeque()
+{
+    std::deque<UDPDatagram> datagramQueue;
+    std::mutex ioMutex;
+    auto startTime = std::chrono::steady_clock::now();
+    std::thread producer{[&]() {
+        for (size_t i = 0; i < DATAGRAM_COUNT; i++) {
+            UDPDatagram datagram{makeDatagram(i)};
+            std::lock_guard<std::mutex> ioLock{ioMutex};
+            datagramQueue.push_back(std::move(datagram));
+        }
+    }};
+    size_t consumed{0};
+    while (consumed < DATAGRAM_COUNT) {
+        std::lock_guard<std::mutex> ioLock{ioMutex};
+        if (!datagramQueue.empty()) {
+            UDPDatagram datagram{std::move(datagramQueue.front())};
+            datagramQueue.pop_front();
+            consumed++;
+        }
+    }
+    producer.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+double benchmarkRingBuffer()
+{
+    SPSCRingBuffer<UDPDatagram> datagramRing{RING_BUFFER_CAPACITY};
+    auto startTime = std::chrono::steady_clock::now();
+    std::thread producer{[&]() {
+        for (size_t i = 0; i < DATAGRAM_COUNT; i++) {
+            UDPDatagram datagram{makeDatagram(i)};
+            while (!datagramRing.tryPush(std::move(datagram))) {
+                std::this_thread::yield();
+            }
+        }
+    }};
+    size_t consumed{0};
+    UDPDatagram datagram{};
+    while (consumed < DATAGRAM_COUNT) {
+        if (datagramRing.tryPop(datagram)) {
+            consumed++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+int main()
+{
+    double dequeSeconds{benchmarkDeque()};
+    double ringBufferSeconds{benchmarkRingBuffer()};
+    std::cout << "Datagrams transferred: " << DATAGRAM_COUNT << std::endl;
+    std::cout << "std::deque + std::mutex: " << dequeSeconds << "s (" << (DATAGRAM_COUNT / dequeSeconds) / 1e6 << " M datagrams/s)" << std::endl;
+    std::cout << "SPSCRingBuffer (capacity " << RING_BUFFER_CAPACITY << "): " << ringBufferSeconds << "s (" << (DATAGRAM_COUNT / ringBufferSeconds) / 1e6 << " M datagrams/s)" << std::endl;
+    return 0;
+}
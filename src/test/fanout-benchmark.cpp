@@ -0,0 +1,60 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <ctime>
+#include <udpduplex.h>
+
+static const uint16_t BENCHMARK_PORT_NUMBER{9180};
+static const size_t ENDPOINT_COUNT{32};
+static const std::chrono::seconds BENCHMARK_DURATION{2};
+static const std::string FAN_OUT_MESSAGE{"{dwrite:13:1}"};
+
+static double threadCpuSeconds()
+{
+    timespec cpuTime{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime);
+    return cpuTime.tv_sec + (cpuTime.tv_nsec / 1e9);
+}
+
+//Nobody reads the server sockets, the kernel just drops once they fill, so only the send side is measured
+static void benchmarkFanOut(bool writeToAll, uint16_t portNumber)
+{
+    std::vector<std::unique_ptr<UDPServer>> sinks{};
+    std::vector<UDPEndpoint> endpoints{};
+    for (size_t i = 0; i < ENDPOINT_COUNT; i++) {
+        sinks.emplace_back(new UDPServer{static_cast<uint16_t>(portNumber + i)});
+        endpoints.emplace_back("127.0.0.1", static_cast<uint16_t>(portNumber + i));
+    }
+    UDPClient client{"127.0.0.1", portNumber};
+    size_t sentCount{0};
+    double startCpuSeconds{threadCpuSeconds()};
+    auto startTime = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - startTime < BENCHMARK_DURATION) {
+        if (writeToAll) {
+            for (auto &it : client.writeToAll(FAN_OUT_MESSAGE, endpoints)) {
+                sentCount += (it > 0 ? 1 : 0);
+            }
+        } else {
+            //What the broadcast tooling did before, retargeting the client for every peer
+            for (auto &it : endpoints) {
+                client.setHostName(it.hostName());
+                client.setPortNumber(it.portNumber());
+                sentCount += (client.writeLine(FAN_OUT_MESSAGE) > 0 ? 1 : 0);
+            }
+        }
+    }
+    double elapsedSeconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count()};
+    double cpuSeconds{threadCpuSeconds() - startCpuSeconds};
+    std::cout << (writeToAll ? "writeToAll:         " : "retarget+writeLine: ")
+              << (sentCount / elapsedSeconds) / 1e3 << " K datagrams/s, "
+              << (sentCount > 0 ? (cpuSeconds * 1e9) / sentCount : 0) << " ns CPU per datagram" << std::endl;
+}
+
+int main()
+{
+    benchmarkFanOut(false, BENCHMARK_PORT_NUMBER);
+    benchmarkFanOut(true, BENCHMARK_PORT_NUMBER + ENDPOINT_COUNT);
+    return 0;
+}
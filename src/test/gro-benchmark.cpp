@@ -0,0 +1,75 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <memory.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <arpa/inet.h>
+#include <udpduplex.h>
+
+static const uint16_t BENCHMARK_PORT_NUMBER{9150};
+static const size_t SEGMENT_SIZE{64};
+static const size_t SEGMENTS_PER_SEND{32};
+static const size_t RECEIVE_BATCH_SIZE{32};
+static const std::chrono::seconds BENCHMARK_DURATION{2};
+
+//UDP_SEGMENT makes the sender emit trains of equal sized datagrams on loopback, which is what GRO coalesces
+static void sendSegmentedTraffic(const std::atomic<bool> *keepSending, uint16_t portNumber)
+{
+    int socketNumber{socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)};
+    sockaddr_in destination{};
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(portNumber);
+    destination.sin_addr.s_addr = inet_addr("127.0.0.1");
+#if defined(UDP_SEGMENT)
+    int segmentSize{static_cast<int>(SEGMENT_SIZE)};
+    setsockopt(socketNumber, SOL_UDP, UDP_SEGMENT, &segmentSize, sizeof(segmentSize));
+#endif
+    std::vector<char> payload(SEGMENT_SIZE * SEGMENTS_PER_SEND, 'x');
+    while (keepSending->load()) {
+        sendto(socketNumber, payload.data(), payload.size(), 0, reinterpret_cast<sockaddr *>(&destination), sizeof(destination));
+    }
+    close(socketNumber);
+}
+
+static double benchmarkReceive(bool receiveGRO, uint16_t portNumber)
+{
+    UDPServer server{portNumber};
+    server.setReceiveBatchSize(RECEIVE_BATCH_SIZE);
+    if (receiveGRO) {
+        server.setReceiveGRO(true);
+    }
+    server.startListening();
+    std::atomic<bool> keepSending{true};
+    std::thread sender{sendSegmentedTraffic, &keepSending, portNumber};
+    size_t receivedCount{0};
+    auto startTime = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - startTime < BENCHMARK_DURATION) {
+        if (server.waitForDatagram(std::chrono::milliseconds(10))) {
+            while (server.available()) {
+                UDPDatagram datagram{server.readDatagram()};
+                receivedCount++;
+            }
+        }
+    }
+    double elapsedSeconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count()};
+    keepSending = false;
+    sender.join();
+    server.stopListening();
+    return receivedCount / elapsedSeconds;
+}
+
+int main()
+{
+    double withoutGRO{benchmarkReceive(false, BENCHMARK_PORT_NUMBER)};
+    double withGRO{benchmarkReceive(true, BENCHMARK_PORT_NUMBER + 1)};
+    std::cout << "Segment size: " << SEGMENT_SIZE << " bytes, " << SEGMENTS_PER_SEND << " segments per send" << std::endl;
+    std::cout << "Without UDP_GRO: " << withoutGRO / 1e3 << " K datagrams/s" << std::endl;
+    std::cout << "With UDP_GRO: " << withGRO / 1e3 << " K datagrams/s" << std::endl;
+    return 0;
+}
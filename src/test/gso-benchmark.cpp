@@ -0,0 +1,47 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <ctime>
+#include <udpduplex.h>
+
+static const uint16_t BENCHMARK_PORT_NUMBER{9170};
+static const size_t FRAME_SIZE{64};
+static const size_t FRAMES_PER_BATCH{UDPClient::MAXIMUM_GSO_SEGMENTS};
+static const std::chrono::seconds BENCHMARK_DURATION{2};
+
+static double threadCpuSeconds()
+{
+    timespec cpuTime{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime);
+    return cpuTime.tv_sec + (cpuTime.tv_nsec / 1e9);
+}
+
+//Nobody reads the server socket, the kernel just drops once it fills, so only the send side is measured
+static void benchmarkSend(bool sendGSO, uint16_t portNumber)
+{
+    UDPServer sink{portNumber};
+    UDPClient client{"127.0.0.1", portNumber};
+    client.setSendGSO(sendGSO);
+    std::vector<std::string> frames(FRAMES_PER_BATCH, std::string(FRAME_SIZE - client.lineEnding().size(), 'x'));
+    size_t sentCount{0};
+    double startCpuSeconds{threadCpuSeconds()};
+    auto startTime = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - startTime < BENCHMARK_DURATION) {
+        for (auto &it : client.writeBatch(frames)) {
+            sentCount += (it > 0 ? 1 : 0);
+        }
+    }
+    double elapsedSeconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count()};
+    double cpuSeconds{threadCpuSeconds() - startCpuSeconds};
+    std::cout << (sendGSO ? (client.sendGSO() ? "UDP_SEGMENT: " : "UDP_SEGMENT (fell back): ") : "sendmmsg:    ")
+              << (sentCount / elapsedSeconds) / 1e3 << " K datagrams/s, "
+              << (sentCount > 0 ? (cpuSeconds * 1e9) / sentCount : 0) << " ns CPU per datagram" << std::endl;
+}
+
+int main()
+{
+    benchmarkSend(false, BENCHMARK_PORT_NUMBER);
+    benchmarkSend(true, BENCHMARK_PORT_NUMBER + 1);
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <ctime>
+#include <memory.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <udpduplex.h>
+
+static const uint16_t BENCHMARK_PORT_NUMBER{9160};
+static const size_t DATAGRAM_SIZE{64};
+static const std::chrono::seconds BENCHMARK_DURATION{2};
+
+//The sender runs in its own process, so this process's CPU time is only the receive side
+static pid_t startSender(uint16_t portNumber)
+{
+    pid_t senderPid{fork()};
+    if (senderPid != 0) {
+        return senderPid;
+    }
+    int socketNumber{socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)};
+    sockaddr_in destination{};
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(portNumber);
+    destination.sin_addr.s_addr = inet_addr("127.0.0.1");
+    std::vector<char> payload(DATAGRAM_SIZE, 'x');
+    while (true) {
+        sendto(socketNumber, payload.data(), payload.size(), 0, reinterpret_cast<sockaddr *>(&destination), sizeof(destination));
+    }
+}
+
+static double processCpuSeconds()
+{
+    timespec cpuTime{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpuTime);
+    return cpuTime.tv_sec + (cpuTime.tv_nsec / 1e9);
+}
+
+static void benchmarkReceive(UDPIOEngine ioEngine, uint16_t portNumber)
+{
+    UDPServer server{portNumber, ioEngine};
+    server.setReceiveBatchSize(UDPServer::MAXIMUM_RECEIVE_BATCH_SIZE);
+    server.setDatagramQueueType(DatagramQueueType::RingBuffer);
+    server.startListening();
+    pid_t senderPid{startSender(portNumber)};
+    size_t receivedCount{0};
+    double startCpuSeconds{processCpuSeconds()};
+    auto startTime = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - startTime < BENCHMARK_DURATION) {
+        if (server.waitForDatagram(std::chrono::milliseconds(10))) {
+            while (server.available()) {
+                UDPDatagram datagram{server.readDatagram()};
+                receivedCount++;
+            }
+        }
+    }
+    double elapsedSeconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count()};
+    double cpuSeconds{processCpuSeconds() - startCpuSeconds};
+    kill(senderPid, SIGKILL);
+    waitpid(senderPid, nullptr, 0);
+    server.stopListening();
+    std::cout << (server.ioEngine() == UDPIOEngine::IoUring ? "io_uring: " : "socket:   ")
+              << (receivedCount / elapsedSeconds) / 1e3 << " K datagrams/s, "
+              << (receivedCount > 0 ? (cpuSeconds * 1e9) / receivedCount : 0) << " ns CPU per datagram" << std::endl;
+}
+
+int main()
+{
+    benchmarkReceive(UDPIOEngine::Socket, BENCHMARK_PORT_NUMBER);
+    benchmarkReceive(UDPIOEngine::IoUring, BENCHMARK_PORT_NUMBER + 1);
+    return 0;
+}
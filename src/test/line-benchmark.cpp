@@ -0,0 +1,106 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <netinet/in.h>
+#include <udpduplex.h>
+#include <delimitersearch.h>
+
+static const uint16_t BENCHMARK_PORT_NUMBER{9190};
+static const std::string LINE_ENDING{"\r\n"};
+static const size_t STREAM_SIZE{64 * 1024 * 1024};
+static const size_t TOTAL_BYTES{1024ULL * 1024 * 1024};
+static const size_t CHUNK_SIZE{1472};
+
+//Mostly short lines, with the odd one long enough to span several datagrams
+static std::string makeLineStream()
+{
+    std::mt19937 randomEngine{2017};
+    std::string lineStream{};
+    lineStream.reserve(STREAM_SIZE + 8192);
+    while (lineStream.size() < STREAM_SIZE) {
+        size_t lineLength{(randomEngine() % 16 == 0) ? (randomEngine() % 8192) : (randomEngine() % 120)};
+        for (size_t i = 0; i < lineLength; i++) {
+            lineStream.push_back(static_cast<char>('a' + (randomEngine() % 26)));
+        }
+        lineStream += LINE_ENDING;
+    }
+    //The stream is sent over and over, so it has to end on a line ending
+    lineStream.resize(lineStream.rfind(LINE_ENDING) + LINE_ENDING.size());
+    return lineStream;
+}
+
+template <typename Search>
+static void benchmarkSearch(const char *name, const std::string &lineStream, Search search)
+{
+    size_t lineCount{0};
+    size_t searchedBytes{0};
+    auto startTime = std::chrono::steady_clock::now();
+    while (searchedBytes < TOTAL_BYTES) {
+        const char *data{lineStream.data()};
+        size_t length{lineStream.size()};
+        while (length > 0) {
+            size_t lineLength{search(data, length) + LINE_ENDING.size()};
+            data += lineLength;
+            length -= lineLength;
+            lineCount++;
+        }
+        searchedBytes += lineStream.size();
+    }
+    double elapsedSeconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count()};
+    std::cout << name << (searchedBytes / elapsedSeconds) / 1e9 << " GB/s, " << lineCount << " lines" << std::endl;
+}
+
+//The datagrams are queued up front, so only line assembly is timed and not the loopback path
+static void benchmarkReadLine(bool readLineView, const std::string &lineStream, uint16_t portNumber)
+{
+    UDPServer server{portNumber};
+    server.setLineEnding(LINE_ENDING);
+    server.setStreamingLines(true);
+    server.startListening();
+    size_t readBytes{0};
+    size_t lineCount{0};
+    double elapsedSeconds{0.0};
+    while (readBytes < TOTAL_BYTES) {
+        //putBack() queues at the front, so the chunks go in last to first
+        for (size_t position = ((lineStream.size() - 1) / CHUNK_SIZE) * CHUNK_SIZE; ; position -= CHUNK_SIZE) {
+            server.putBack(UDPDatagram{sockaddr_in{}, lineStream.data() + position, std::min(CHUNK_SIZE, lineStream.size() - position)});
+            if (position == 0) {
+                break;
+            }
+        }
+        size_t passBytes{0};
+        auto startTime = std::chrono::steady_clock::now();
+        while (passBytes < lineStream.size()) {
+            passBytes += (readLineView ? server.readLineView().size() : server.readLine().size());
+            lineCount++;
+        }
+        elapsedSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        readBytes += passBytes;
+    }
+    server.stopListening();
+    std::cout << (readLineView ? "readLineView(): " : "readLine():     ")
+              << (readBytes / elapsedSeconds) / 1e9 << " GB/s, "
+              << (lineCount / elapsedSeconds) / 1e6 << " M lines/s" << std::endl;
+}
+
+int main()
+{
+    std::string lineStream{makeLineStream()};
+    std::cout << "Delimiter search over " << TOTAL_BYTES / (1024 * 1024) << " MB of mixed-length lines (" << delimiterSearchInstructionSet() << " dispatched)" << std::endl;
+    benchmarkSearch("std::search:           ", lineStream, [](const char *data, size_t length) {
+        return static_cast<size_t>(std::search(data, data + length, LINE_ENDING.begin(), LINE_ENDING.end()) - data);
+    });
+    benchmarkSearch("findDelimiterScalar(): ", lineStream, [](const char *data, size_t length) {
+        return findDelimiterScalar(data, length, LINE_ENDING.data(), LINE_ENDING.size());
+    });
+    benchmarkSearch("findDelimiter():       ", lineStream, [](const char *data, size_t length) {
+        return findDelimiter(data, length, LINE_ENDING.data(), LINE_ENDING.size());
+    });
+    std::cout << "Streaming line assembly over " << CHUNK_SIZE << " byte datagrams" << std::endl;
+    benchmarkReadLine(false, lineStream, BENCHMARK_PORT_NUMBER);
+    benchmarkReadLine(true, lineStream, BENCHMARK_PORT_NUMBER + 1);
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <udpduplex.h>
+
+static const uint16_t STRESS_PORT_NUMBER{9200};
+static const std::chrono::seconds STRESS_DURATION{5};
+static const size_t RECEIVE_QUEUE_DATAGRAM_LIMIT{8};
+static const size_t LINES_PER_DATAGRAM{4};
+static const size_t LINE_PAYLOAD_SIZE{200};
+static const std::chrono::microseconds READER_DELAY{20};
+
+//Each line is "<datagram>:<line>:" and a payload of one repeated letter, so a recycled buffer shows up as a bad line
+static std::string makeDatagram(size_t datagramNumber)
+{
+    std::string datagram{};
+    for (size_t i = 0; i < LINES_PER_DATAGRAM; i++) {
+        datagram += std::to_string(datagramNumber) + ":" + std::to_string(i) + ":";
+        datagram += std::string(LINE_PAYLOAD_SIZE, static_cast<char>('a' + (datagramNumber + i) % 26));
+        if (i + 1 < LINES_PER_DATAGRAM) {
+            datagram += UDPServer::DEFAULT_LINE_ENDING;
+        }
+    }
+    return datagram;
+}
+
+static bool isValidLine(const std::string &line, size_t *datagramNumber, size_t *lineNumber)
+{
+    size_t firstColon{line.find(':')};
+    size_t secondColon{line.find(':', firstColon + 1)};
+    if ((firstColon == std::string::npos) || (secondColon == std::string::npos)) {
+        return false;
+    }
+    *datagramNumber = std::stoul(line.substr(0, firstColon));
+    *lineNumber = std::stoul(line.substr(firstColon + 1, secondColon - firstColon - 1));
+    std::string expectedPayload(LINE_PAYLOAD_SIZE, static_cast<char>('a' + (*datagramNumber + *lineNumber) % 26));
+    return (line.compare(secondColon + 1, std::string::npos, expectedPayload + UDPServer::DEFAULT_LINE_ENDING) == 0);
+}
+
+//The listener evicts under DropOldest while readLine() walks partly read datagrams, which must never be the ones evicted
+int main()
+{
+    UDPServer server{STRESS_PORT_NUMBER};
+    server.setReceiveQueueLimit(RECEIVE_QUEUE_DATAGRAM_LIMIT);
+    server.setReceiveQueuePolicy(ReceiveQueuePolicy::DropOldest);
+    server.setTimeout(10);
+    server.startListening();
+    std::atomic<bool> isSending{true};
+    std::thread sender{[&isSending]() {
+        UDPClient client{"127.0.0.1", STRESS_PORT_NUMBER};
+        for (size_t datagramNumber = 0; isSending; datagramNumber++) {
+            client.writeLine(makeDatagram(datagramNumber));
+        }
+    }};
+    size_t lineCount{0};
+    size_t badLineCount{0};
+    size_t cursorJumpCount{0};
+    size_t previousDatagramNumber{0};
+    size_t previousLineNumber{LINES_PER_DATAGRAM - 1};
+    auto startTime = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - startTime < STRESS_DURATION) {
+        std::string line{server.readLine()};
+        if (line.empty()) {
+            continue;
+        }
+        size_t datagramNumber{0};
+        size_t lineNumber{0};
+        if (!isValidLine(line, &datagramNumber, &lineNumber)) {
+            badLineCount++;
+            continue;
+        }
+        //Once a datagram is partly read, its next line has to follow
+        if ((previousLineNumber + 1 < LINES_PER_DATAGRAM) && ((datagramNumber != previousDatagramNumber) || (lineNumber != previousLineNumber + 1))) {
+            cursorJumpCount++;
+        }
+        previousDatagramNumber = datagramNumber;
+        previousLineNumber = lineNumber;
+        lineCount++;
+        //A slow reader keeps the queue full, so the listener is evicting while a datagram is partly read
+        std::this_thread::sleep_for(READER_DELAY);
+    }
+    isSending = false;
+    sender.join();
+    server.stopListening();
+    std::cout << lineCount << " lines read, " << server.droppedDatagramCount() << " datagrams dropped, "
+              << badLineCount << " bad lines, " << cursorJumpCount << " cursor jumps" << std::endl;
+    return (((badLineCount == 0) && (cursorJumpCount == 0) && (server.droppedDatagramCount() > 0)) ? 0 : 1);
+}
@@ -78,7 +78,10 @@ static std::list<const char *> SEND_ONLY_SWITCHES{"-s", "--s", "-send", "--send"
 static std::list<const char *> LINE_ENDING_SWITCHES{"-e", "--e", "-line-ending", "--line-ending", "-line-endings", "--line-endings"};
 static std::list<const char *> RECEIVE_ONLY_SWITCHES{"-receive", "--receive", "-receive-only", "--receive-only"};
 static std::list<const char *> SYNCHRONOUS_COMMUNICATION_SWITCHES{"-sync", "--sync", "-sync-comm", "--sync-comm"};
+static std::list<const char *> SINGLE_SOCKET_SWITCHES{"-single-socket", "--single-socket"};
 static std::list<const char *> SCRIPT_FILE_SWITCHES{"-c", "--c", "-script", "--script", "-script-file", "--script-file", "-script-name", "--script-name"};
+static std::list<const char *> SEND_RATE_SWITCHES{"-r", "--r", "-send-rate", "--send-rate"};
+static std::list<const char *> SEND_BYTE_RATE_SWITCHES{"-b", "--b", "-send-byte-rate", "--send-byte-rate"};
 static std::list<const char *> VERSION_SWITCHES{"-v", "--v", "-version", "--version"};
 static std::list<const char *> HELP_SWITCHES{"-h", "--h", "-help", "--help"};
 
@@ -245,6 +248,7 @@ namespace UDPCommunicationUtilities {
 using namespace UDPCommunicationUtilities;
 
 bool isValidIpAddress(const char *str);
+bool parseSendRate(const char *switchName, const std::string &maybeRateString, double *sendRate);
 bool isValidWebAddress(const char *str);
 static std::unique_ptr<PrettyPrinter> prettyPrinter{std::unique_ptr<PrettyPrinter>{new PrettyPrinter{}}};
 
@@ -262,6 +266,10 @@ static const int RX_RESULT_WHITESPACE{4};
 static const int DELAY_RESULT_WHITESPACE{4};
 static const int FLUSH_RESULT_WHITESPACE{4};
 static const int LOOP_RESULT_WHITESPACE{4};
+static const int STDOUT_WAIT_TIMEOUT{100};
+//A terminal that stops reading keeps the most recent traffic instead of all of it
+static const size_t RECEIVE_QUEUE_DATAGRAM_LIMIT{65536};
+static const size_t RECEIVE_QUEUE_BYTE_LIMIT{64 * 1024 * 1024};
 
 void sendUDPString(const std::string &str);
 std::string doUDPreadLine();
@@ -322,8 +330,11 @@ static std::string clientReturnAddressPortNumber{std::to_string(randomBetween(0,
 static bool sendOnly{false};
 static bool receiveOnly{false};
 static bool synchronousCommunication{false};
+static bool singleSocket{false};
 static std::vector<std::string> previousStringSent{};
 static std::string lineEndings{""};
+static double sendPacketRate{0.0};
+static double sendByteRate{0.0};
 
 const uint16_t MAXIMUM_PORT_NUMBER{std::numeric_limits<uint16_t>::max()};
 
@@ -516,6 +527,22 @@ int main(int argc, char *argv[])
                     }
                 }   
             }
+        } else if ((isSwitch(argv[i], SEND_RATE_SWITCHES)) || (isSwitch(argv[i], SEND_BYTE_RATE_SWITCHES))) {
+            if (argv[i+1]) {
+                parseSendRate(argv[i], static_cast<std::string>(argv[i+1]), (isSwitch(argv[i], SEND_RATE_SWITCHES) ? &sendPacketRate : &sendByteRate));
+            } else {
+                std::cout << "WARNING: Switch " << tQuoted(argv[i]) << " accepted, but no send rate was specified after, skipping option" << std::endl;
+            }
+            i++;
+        } else if ((isEqualsSwitch(argv[i], SEND_RATE_SWITCHES)) || (isEqualsSwitch(argv[i], SEND_BYTE_RATE_SWITCHES))) {
+            std::string copyString{static_cast<std::string>(argv[i])};
+            size_t foundPosition{copyString.find("=")};
+            size_t foundEnd{copyString.substr(foundPosition).find(" ")};
+            if (copyString.substr(foundPosition+1, (foundEnd - foundPosition)) == "") {
+                std::cout << "WARNING: Switch " << tQuoted(argv[i]) << " accepted, but no send rate was specified after, skipping option" << std::endl;
+            } else {
+                parseSendRate(argv[i], stripAllFromString(copyString.substr(foundPosition+1, (foundEnd - foundPosition)), "\""), (isEqualsSwitch(argv[i], SEND_RATE_SWITCHES) ? &sendPacketRate : &sendByteRate));
+            }
         }  else if (isSwitch(argv[i], SCRIPT_FILE_SWITCHES)) {
             if (argv[i+1]) {
                 scriptFiles.emplace(static_cast<std::string>(argv[i+1]));
@@ -556,6 +583,14 @@ int main(int argc, char *argv[])
             } else {
                 synchronousCommunication = true;
             }
+        } else if (isSwitch(argv[i], SINGLE_SOCKET_SWITCHES)) {
+            if (sendOnly) {
+                std::cout << "WARNING: Switch " << argv[i] << " accepted, but SendOnly option is already enabled, skipping option" << std::endl;
+            } else if (receiveOnly) {
+                std::cout << "WARNING: Switch " << argv[i] << " accepted, but ReceiveOnly option is already enabled, skipping option" << std::endl;
+            } else {
+                singleSocket = true;
+            }
         } else if (((isValidIpAddress(argv[i])) || (isValidWebAddress(argv[i]))) && (!startsWith(std::string{argv[i]}, "-"))) {
             if (clientHostName == UDPDuplex::DEFAULT_CLIENT_HOST_NAME) {
                 clientHostName = argv[i];
@@ -584,7 +619,7 @@ int main(int argc, char *argv[])
     prettyPrinter->println(clientPortNumber);
     
     std::cout << "Using ServerPortNumber=";
-    if (udpObjectType == UDPObjectType::Server) {
+    if ((udpObjectType == UDPObjectType::Server) || (singleSocket)) {
         prettyPrinter->println(serverPortNumber);
     } else {
         prettyPrinter->println(clientReturnAddressPortNumber);
@@ -596,6 +631,15 @@ int main(int argc, char *argv[])
     std::cout << "Using LineEndings=";
     prettyPrinter->println(getPrettyLineEndings(lineEndings));
 
+    if (sendPacketRate > 0.0) {
+        std::cout << "Using SendRate=";
+        prettyPrinter->println(toStdString(sendPacketRate) + " packets/s");
+    }
+    if (sendByteRate > 0.0) {
+        std::cout << "Using SendByteRate=";
+        prettyPrinter->println(toStdString(sendByteRate) + " bytes/s");
+    }
+
     int i{1};
     for (auto &it : scriptFiles) {
         std::cout << "Using ScriptFile=" << it << " (" << i++ << "/" << scriptFiles.size() << ")" << std::endl;
@@ -604,6 +648,8 @@ int main(int argc, char *argv[])
         udpObjectType = UDPObjectType::Server;
     } else if (sendOnly) {
         udpObjectType = UDPObjectType::Client;
+    } else if (singleSocket) {
+        udpObjectType = UDPObjectType::SingleSocketDuplex;
     } else {
         udpObjectType = UDPObjectType::Duplex;
     }
@@ -614,6 +660,11 @@ int main(int argc, char *argv[])
                                                     std::stoi(serverPortNumber),
                                                     std::stoi(clientReturnAddressPortNumber),
                                                     udpObjectType);
+        if ((sendPacketRate > 0.0) || (sendByteRate > 0.0)) {
+            udpDuplex->setClientSendRate(sendPacketRate, sendByteRate);
+        }
+        udpDuplex->setServerReceiveQueueLimit(RECEIVE_QUEUE_DATAGRAM_LIMIT, RECEIVE_QUEUE_BYTE_LIMIT);
+        udpDuplex->setServerReceiveQueuePolicy(ReceiveQueuePolicy::DropOldest);
         try {
             udpDuplex->openPort();
         } catch (std::exception &e) {
@@ -622,6 +673,7 @@ int main(int argc, char *argv[])
         }
         delayMilliseconds(500);
         udpDuplex->setTimeout(25);        
+        udpDuplex->startListening();
         std::cout << "Successfully opened UDP port ";
         prettyPrinter->println(udpDuplex->portName() + "\n");
         for (auto &it : scriptFiles) {
@@ -766,6 +818,9 @@ void displayHelp()
     std::cout << "    -e, --e, -line-ending, --line-ending: Specify what type of line ending should be used" << std::endl;
     std::cout << "    -a, --a, -client-return-address-host-name: Specify the return address host name for the UDP client" << std::endl;
     std::cout << "    -g, --g, -client-return-address-port-number: Specify the return address port number for the UDP client" << std::endl; 
+    std::cout << "    -r, --r, -send-rate, --send-rate: Limit how many datagrams per second are sent" << std::endl;
+    std::cout << "    -b, --b, -send-byte-rate, --send-byte-rate: Limit how many bytes per second are sent" << std::endl;
+    std::cout << "    -single-socket, --single-socket: Send and receive on one socket bound to the server port number" << std::endl;
     std::cout << "    -h, --h, -help, --help: Show this help text" << std::endl;
     std::cout << "    -v, --v, -version, --version: Display version" << std::endl;
     std::cout << "Example: " << std::endl;
@@ -863,7 +918,7 @@ std::string asyncStdoutTask()
         if (!udpDuplex) {
             return "";
         }
-        if (udpDuplex->available()) {
+        if (udpDuplex->waitForDatagram(std::chrono::milliseconds(STDOUT_WAIT_TIMEOUT))) {
             returnString += udpDuplex->readLine();
         }
     } while ((returnString.length() == 0) || (isWhitespace(returnString)));
@@ -1000,6 +1055,23 @@ void printLoopResult(LoopType loopType, int currentLoop, int loopCount)
     }
 }
 
+bool parseSendRate(const char *switchName, const std::string &maybeRateString, double *sendRate)
+{
+    try {
+        double maybeRate{std::stod(maybeRateString)};
+        if (maybeRate <= 0.0) {
+            std::cout << "WARNING: Switch " << tQuoted(switchName) << " accepted, but specified send rate " << tQuoted(maybeRateString) << " is not a positive number, skipping option" << std::endl;
+            return false;
+        }
+        *sendRate = maybeRate;
+        return true;
+    } catch (std::exception &e) {
+        (void)e;
+        std::cout << "WARNING: Switch " << tQuoted(switchName) << " accepted, but specified send rate " << tQuoted(maybeRateString) << " is not a number, skipping option" << std::endl;
+        return false;
+    }
+}
+
 bool isValidIpAddress(const char *str)
 {
     std::string copyString{str};
@@ -28,17 +28,43 @@
 #include <limits>
 #include <mutex>
 #include <memory.h>
+#include <poll.h>
+#include <netinet/udp.h>
+#if defined(__linux__)
+    #include <linux/errqueue.h>
+    #include <linux/filter.h>
+    #include <linux/net_tstamp.h>
+    #include <pthread.h>
+    #include <sched.h>
+#endif
 
 #include "udpduplex.h"
+#include "udpreactor.h"
+#include "udpiouring.h"
+#include "delimitersearch.h"
+
+inline bool endsWith(const char *stringToCheck, size_t length, const std::string &matchString)
+{
+    return (matchString.size() > length) ? false : (memcmp(stringToCheck + length - matchString.size(), matchString.data(), matchString.size()) == 0);
+}
 
 inline bool endsWith(const std::string &stringToCheck, const std::string &matchString)
 {
-    return (matchString.size() > stringToCheck.size()) ? false : std::equal(matchString.rbegin(), matchString.rend(), stringToCheck.rbegin());
+    return endsWith(stringToCheck.data(), stringToCheck.size(), matchString);
 }
 
 inline bool endsWith(const std::string &stringToCheck, char matchChar)
 {
-    return endsWith(stringToCheck, std::string(1, matchChar));
+    return ((!stringToCheck.empty()) && (stringToCheck.back() == matchChar));
+}
+
+static size_t messageLength(const msghdr &messageHeader)
+{
+    size_t length{0};
+    for (size_t i = 0; i < static_cast<size_t>(messageHeader.msg_iovlen); i++) {
+        length += messageHeader.msg_iov[i].iov_len;
+    }
+    return length;
 }
 
 template <typename T> static inline std::string toStdString(const T &t) { 
@@ -64,6 +90,78 @@ template <typename T> static inline std::string tQuoted(const T &t) {
     return "\"" + toStdString(t) + "\"";
 }
 
+static UDPIOEngine availableIOEngine(UDPIOEngine ioEngine)
+{
+#if defined(__linux__)
+    if ((ioEngine == UDPIOEngine::IoUring) && (UDPIoUring::isSupported())) {
+        return UDPIOEngine::IoUring;
+    }
+#endif
+    (void)ioEngine;
+    return UDPIOEngine::Socket;
+}
+
+static std::chrono::system_clock::time_point toTimePoint(const timespec &timestamp)
+{
+    return std::chrono::system_clock::time_point{std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::seconds{timestamp.tv_sec} + std::chrono::nanoseconds{timestamp.tv_nsec})};
+}
+
+static void readControlMessages(msghdr *messageHeader, std::chrono::system_clock::time_point *receiveTimestamp, size_t *segmentSize)
+{
+#if defined(__linux__)
+    for (cmsghdr *controlMessage = CMSG_FIRSTHDR(messageHeader); controlMessage; controlMessage = CMSG_NXTHDR(messageHeader, controlMessage)) {
+        if ((controlMessage->cmsg_level == SOL_SOCKET) && (controlMessage->cmsg_type == SCM_TIMESTAMPING)) {
+            //ts[0] holds the software stamp, the hardware slots stay zero for software RX timestamping
+            scm_timestamping timestamps{};
+            memcpy(&timestamps, CMSG_DATA(controlMessage), sizeof(timestamps));
+            *receiveTimestamp = toTimePoint(timestamps.ts[0]);
+        } else if ((controlMessage->cmsg_level == SOL_SOCKET) && (controlMessage->cmsg_type == SCM_TIMESTAMPNS)) {
+            timespec timestamp{};
+            memcpy(&timestamp, CMSG_DATA(controlMessage), sizeof(timestamp));
+            *receiveTimestamp = toTimePoint(timestamp);
+#if defined(UDP_GRO)
+        } else if ((controlMessage->cmsg_level == SOL_UDP) && (controlMessage->cmsg_type == UDP_GRO)) {
+            int groSegmentSize{0};
+            memcpy(&groSegmentSize, CMSG_DATA(controlMessage), sizeof(groSegmentSize));
+            *segmentSize = static_cast<size_t>(std::max(groSegmentSize, 0));
+#endif
+        }
+    }
+#else
+    (void)messageHeader;
+    (void)receiveTimestamp;
+    (void)segmentSize;
+#endif
+}
+
+#if defined(__linux__)
+static bool attachReusePortSteering(int socketNumber, size_t shardCount)
+{
+#if defined(SO_ATTACH_REUSEPORT_CBPF)
+    //Pick the shard from the source address and port, so every datagram from one peer is read in order by one listener
+    sock_filter steeringProgram[] = {
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, static_cast<uint32_t>(SKF_NET_OFF)),
+        BPF_STMT(BPF_ALU | BPF_AND | BPF_K, 0x0f),
+        BPF_STMT(BPF_ALU | BPF_LSH | BPF_K, 2),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_LD | BPF_H | BPF_IND, static_cast<uint32_t>(SKF_NET_OFF)),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_NET_OFF + 12)),
+        BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, static_cast<uint32_t>(shardCount)),
+        BPF_STMT(BPF_RET | BPF_A, 0)
+    };
+    sock_fprog steeringFilter{};
+    steeringFilter.len = sizeof(steeringProgram) / sizeof(steeringProgram[0]);
+    steeringFilter.filter = steeringProgram;
+    return (setsockopt(socketNumber, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &steeringFilter, sizeof(steeringFilter)) == 0);
+#else
+    return false;
+#endif
+}
+#endif
+
 template<typename T, typename TLow, typename THigh>
 T doUserEnterNumericParameter(const std::string &name,
                                 const std::function<bool(T)> &validator,
@@ -192,7 +290,43 @@ T doUserSelectParameter(const std::string &name,
     }
 }
 
+UDPEndpoint::UDPEndpoint(const std::string &hostName, uint16_t portNumber) :
+    m_socketAddress{}
+{
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo *resultList{nullptr};
+    if (getaddrinfo(hostName.c_str(), std::to_string(portNumber).c_str(), &hints, &resultList) != 0) {
+        throw std::runtime_error("ERROR: UDPEndpoint could not resolve adress " + tQuoted(hostName));
+    }
+    memcpy(&this->m_socketAddress, resultList->ai_addr, sizeof(this->m_socketAddress));
+    freeaddrinfo(resultList);
+}
+
+UDPEndpoint::UDPEndpoint(const sockaddr_in &socketAddress) :
+    m_socketAddress(socketAddress)
+{
+
+}
+
+std::string UDPEndpoint::hostName() const
+{
+    char lowLevelTempBuffer[INET_ADDRSTRLEN];
+    memset(lowLevelTempBuffer, '\0', INET_ADDRSTRLEN);
+    inet_ntop(AF_INET, &(this->m_socketAddress.sin_addr), lowLevelTempBuffer, INET_ADDRSTRLEN);
+    return std::string{lowLevelTempBuffer};
+}
+
+uint16_t UDPEndpoint::portNumber() const
+{
+    return ntohs(this->m_socketAddress.sin_port);
+}
+
 const uint16_t UDPServer::BROADCAST{1};
+//Matches UDPClient::DEFAULT_LINE_ENDING, so coalesced lines are split back apart without any configuration
+const std::string UDPServer::DEFAULT_LINE_ENDING{"\r\n"};
+constexpr size_t UDPServer::RECEIVED_BUFFER_MAX;
 
 UDPServer::UDPServer() :
     UDPServer{UDPServer::DEFAULT_PORT_NUMBER}
@@ -201,16 +335,58 @@ UDPServer::UDPServer() :
 }
 
 UDPServer::UDPServer(uint16_t portNumber) :
+    UDPServer{portNumber, UDPServer::DEFAULT_IO_ENGINE}
+{
+
+}
+
+UDPServer::UDPServer(uint16_t portNumber, UDPIOEngine ioEngine) :
     m_socketAddress{},
     m_isListening{false},
     m_socketNumber{0},
     m_timeout{UDPServer::DEFAULT_TIMEOUT},
     m_datagramQueue{},
-    m_shutEmDown{false}
+    m_datagramRing{nullptr},
+    m_frontReadOffset{0},
+    m_putBackBytes{},
+    m_frontGeneration{0},
+    m_streamingLines{false},
+    m_lineSearch{},
+    m_viewDatagram{},
+    m_assembledLine{},
+    m_receiveQueueDatagramLimit{0},
+    m_receiveQueueByteLimit{0},
+    m_receiveQueuePolicy{UDPServer::DEFAULT_RECEIVE_QUEUE_POLICY},
+    m_queuedByteCount{0},
+    m_droppedDatagramCount{0},
+    m_droppedByteCount{0},
+    m_receiveQueueSpace{},
+    m_datagramWaiterCount{0},
+    m_shutEmDown{false},
+    m_lineEnding{UDPServer::DEFAULT_LINE_ENDING},
+    m_isEchoServer{false},
+    m_receiveBatchSize{UDPServer::DEFAULT_RECEIVE_BATCH_SIZE},
+    m_datagramBufferPool{DatagramBufferPool::create(UDPServer::DEFAULT_POOL_BUFFER_SIZE, UDPServer::DEFAULT_POOL_BUFFER_COUNT)},
+    m_datagramHandler{},
+    m_reactor{nullptr},
+    m_reactorReceiveSlots{},
+    m_reactorReceivedDatagrams{},
+    m_receiveShards{},
+    m_pinReceiveShards{false},
+    m_frontShard{0},
+    m_nextShard{0},
+    m_receiveTimestamps{false},
+    m_receiveGRO{false},
+    m_ioEngine{availableIOEngine(ioEngine)}
 {
     this->initialize(portNumber);
 }
 
+UDPIOEngine UDPServer::ioEngine() const
+{
+    return this->m_ioEngine;
+}
+
 bool constexpr UDPServer::isValidPortNumber(int portNumber)
 {
     return ((portNumber > 0) && (portNumber < std::numeric_limits<uint16_t>::max()));
@@ -238,8 +414,8 @@ void UDPServer::setTimeout(long timeout)
         this->m_timeout = timeout;
     }
     struct timeval tv{};
-    tv.tv_sec = 0;
-    tv.tv_usec = this->m_timeout * 3;
+    tv.tv_sec = this->m_timeout / 1000;
+    tv.tv_usec = (this->m_timeout % 1000) * 1000;
     if (setsockopt(this->m_socketNumber, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0) {
         this->m_timeout = tempTimeout;
         throw std::runtime_error("In UDPServer::setTimeout(long): An error occurred while attempting to set the socket timeout");
@@ -256,8 +432,8 @@ void UDPServer::setTimeout(int socketIndex, long timeout)
         this->m_timeout = timeout;
     }
     struct timeval tv{};
-    tv.tv_sec = 0;
-    tv.tv_usec = this->m_timeout * 3;
+    tv.tv_sec = this->m_timeout / 1000;
+    tv.tv_usec = (this->m_timeout % 1000) * 1000;
     if (setsockopt(socketIndex, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0) {
         this->m_timeout = tempTimeout;
         throw std::runtime_error("In UDPServer::setTimeout(int, long): An error occurred while attempting to set the socket timeout");
@@ -272,7 +448,7 @@ long UDPServer::timeout() const
 void UDPServer::flushRXTX()
 {
     std::lock_guard<std::mutex> ioLock{this->m_ioMutex};
-    this->m_datagramQueue.clear();
+    this->clearQueuedDatagrams();
 }
 
 uint16_t UDPServer::portNumber() const 
@@ -317,6 +493,8 @@ void UDPServer::initialize(uint16_t portNumber)
     if (bind(this->m_socketNumber, reinterpret_cast<sockaddr *>(&this->m_socketAddress), sizeof(sockaddr)) == -1) {
        throw std::runtime_error("ERROR: UDPServer could not bind socket to address " + tQuoted(toStdString(this->m_socketAddress)) + " (is something else using it?)");
     }
+    //The listener thread only notices stopListening() when a receive times out
+    this->setTimeout(this->m_timeout);
     
     
 }
@@ -330,6 +508,7 @@ void UDPServer::startListening(int socketNumber)
             this->m_asyncFuture.join();
             delete this->m_asyncFuture;
         }
+        this->m_shutEmDown = false;
         this->m_asyncFuture = new std::thread{&static_cast<void (UDPServer::*)(int)>(&UDPServer::asyncDatagramListener),
                                               this,
                                               socketNumber};
@@ -342,6 +521,7 @@ void UDPServer::startListening(int socketNumber)
     } catch (std::exception &e) {
         
     }
+    this->m_shutEmDown = false;
     this->m_asyncFuture = std::async(std::launch::async,
                                     static_cast<void (UDPServer::*)(int)>(&UDPServer::asyncDatagramListener),
                                     this,
@@ -352,6 +532,11 @@ void UDPServer::startListening(int socketNumber)
 
 void UDPServer::startListening()
 {
+    if ((!this->m_isListening) && (!this->m_receiveShards.empty())) {
+        this->m_isListening = true;
+        this->m_shutEmDown = false;
+        return this->startReceiveShards();
+    }
     if (!this->m_isListening) {
         this->m_isListening = true;
 #if defined(__ANDROID__)
@@ -359,6 +544,7 @@ void UDPServer::startListening()
             this->m_asyncFuture.join();
             delete this->m_asyncFuture;
         }
+        this->m_shutEmDown = false;
         this->m_asyncFuture = new std::thread{&static_cast<void (UDPServer::*)()>(&UDPServer::asyncDatagramListener),
                                               this};
 #else
@@ -370,6 +556,7 @@ void UDPServer::startListening()
     } catch (std::exception &e) {
         
     }
+    this->m_shutEmDown = false;
     this->m_asyncFuture = std::async(std::launch::async,
                                     static_cast<void (UDPServer::*)()>(&UDPServer::asyncDatagramListener),
                                     this);
@@ -379,8 +566,21 @@ void UDPServer::startListening()
 
 void UDPServer::stopListening()
 {
+#if defined(__linux__)
+    if (this->m_reactor) {
+        return this->m_reactor->detach(*this);
+    }
+#endif
     this->m_shutEmDown = true;
     this->m_isListening = false;
+    {
+        std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
+    }
+    this->m_datagramAvailable.notify_all();
+    this->m_receiveQueueSpace.notify_all();
+    if (!this->m_receiveShards.empty()) {
+        return this->stopReceiveShards();
+    }
 #if defined(__ANDROID__)
     if (this->m_asyncFuture) {
         this->m_asyncFuture->join();
@@ -406,334 +606,1027 @@ bool UDPServer::isListening() const
 
 void UDPServer::asyncDatagramListener()
 {
-    std::unique_lock<std::mutex> ioMutexLock{this->m_ioMutex, std::defer_lock};
-    char lowLevelReceiveBuffer[UDPServer::RECEIVED_BUFFER_MAX];
-    do {
-        memset(lowLevelReceiveBuffer, 0, UDPServer::RECEIVED_BUFFER_MAX);
-        std::string receivedString{""};
-        sockaddr_in receivedAddress{};
-        platform_socklen_t socketSize{sizeof(sockaddr)};
-        ssize_t returnValue {recvfrom(this->m_socketNumber,
-                            lowLevelReceiveBuffer,
-                            sizeof(lowLevelReceiveBuffer)-1,
-                            0,
-                            reinterpret_cast<sockaddr *>(&receivedAddress),
-                            &socketSize)};
-        if ((returnValue == EAGAIN) || (returnValue == EWOULDBLOCK) || (returnValue == -1)) {
-            //No data;
-        } else {
-            receivedString = std::string{lowLevelReceiveBuffer};
-            if (receivedString.length() > 0) {
-                ioMutexLock.lock();
-                this->m_datagramQueue.emplace_back(receivedAddress, receivedString);
-                ioMutexLock.unlock();
-
-            }
-        }
-    } while (!this->m_shutEmDown);
+    return this->asyncDatagramListener(this->m_socketNumber);
 }
 
-
 void UDPServer::asyncDatagramListener(int socketNumber)
 {
-    std::unique_lock<std::mutex> ioMutexLock{this->m_ioMutex, std::defer_lock};
-    char lowLevelReceiveBuffer[UDPServer::RECEIVED_BUFFER_MAX];
+    return this->asyncDatagramListener(socketNumber, this->m_datagramRing.get());
+}
+
+void UDPServer::asyncDatagramListener(int socketNumber, SPSCRingBuffer<UDPDatagram> *datagramRing)
+{
+#if defined(__linux__)
+    if ((this->m_ioEngine == UDPIOEngine::IoUring) && (this->ioUringDatagramListener(socketNumber, datagramRing))) {
+        return;
+    }
+#endif
+    const size_t batchSize{this->m_receiveBatchSize};
+    ReceiveOverflowBuffers overflowBuffers{};
+    overflowBuffers.reserve(batchSize);
+    std::vector<ReceiveSlot> receiveSlots(batchSize);
+    std::vector<UDPDatagram> receivedDatagrams{};
+    receivedDatagrams.reserve(batchSize);
+#if defined(__linux__)
+    std::vector<mmsghdr> messageHeaders(batchSize);
+#endif
+    bool useBatchedReceive{false};
     do {
-        memset(lowLevelReceiveBuffer, 0, UDPServer::RECEIVED_BUFFER_MAX);
-        std::string receivedString{""};
-        sockaddr_in receivedAddress{};
-        platform_socklen_t socketSize{sizeof(sockaddr)};
-        ssize_t returnValue {recvfrom(socketNumber,
-                            lowLevelReceiveBuffer,
-                            sizeof(lowLevelReceiveBuffer)-1,
-                            0,
-                            reinterpret_cast<sockaddr *>(&receivedAddress),
-                            &socketSize)};
-        if ((returnValue == EAGAIN) || (returnValue == EWOULDBLOCK) || (returnValue == -1)) {
-            //No data;
-        } else {
-            receivedString = std::string{lowLevelReceiveBuffer};
-            if (receivedString.length() > 0) {
-                ioMutexLock.lock();
-                this->m_datagramQueue.emplace_back(receivedAddress, receivedString);
-                ioMutexLock.unlock();
+        size_t receivedCount{0};
+#if defined(__linux__)
+        if (useBatchedReceive) {
+            for (size_t i = 0; i < batchSize; i++) {
+                this->prepareReceiveSlot(receiveSlots[i], overflowBuffers.slot(i));
             }
+            int returnValue{this->receiveDatagramBatch(socketNumber, receiveSlots, messageHeaders)};
+            receivedCount = (returnValue > 0 ? static_cast<size_t>(returnValue) : 0);
+            //Drop back to blocking single reads once the socket has no backlog left to drain
+            useBatchedReceive = (returnValue > 1);
+        }
+#endif
+        if (receivedCount == 0) {
+            this->prepareReceiveSlot(receiveSlots[0], overflowBuffers.slot(0));
+            ssize_t returnValue{this->receiveDatagram(socketNumber, receiveSlots[0], 0)};
+            receivedCount = (returnValue > 0 ? 1 : 0);
+            useBatchedReceive = ((returnValue > 0) && (batchSize > 1));
+        }
+        receivedDatagrams.clear();
+        for (size_t i = 0; i < receivedCount; i++) {
+            this->takeReceivedDatagrams(receiveSlots[i], overflowBuffers.slot(i), receivedDatagrams);
+        }
+        if (!receivedDatagrams.empty()) {
+            this->enqueueDatagrams(receivedDatagrams.data(), receivedDatagrams.size(), datagramRing);
+            this->notifyDatagramWaiters();
         }
     } while (!this->m_shutEmDown);
 }
 
-void UDPServer::syncDatagramListener(int socketNumber)
+void UDPServer::prepareReceiveSlot(ReceiveSlot &receiveSlot, char *overflowBuffer)
 {
-    std::unique_lock<std::mutex> ioMutexLock{this->m_ioMutex, std::defer_lock};
-    char lowLevelReceiveBuffer[UDPServer::RECEIVED_BUFFER_MAX];
-    memset(lowLevelReceiveBuffer, 0, UDPServer::RECEIVED_BUFFER_MAX);
-    std::string receivedString{""};
-    sockaddr_in receivedAddress{};
-    platform_socklen_t socketSize{sizeof(sockaddr)};
-    ssize_t returnValue{recvfrom(socketNumber,
-                        lowLevelReceiveBuffer,
-                        sizeof(lowLevelReceiveBuffer)-1,
-                        0,
-                        reinterpret_cast<sockaddr *>(&receivedAddress),
-                        &socketSize)};
-    if ((returnValue == EAGAIN) || (returnValue == EWOULDBLOCK) || (returnValue == -1)) {
-        return;
+    //Slots keep an unused pool buffer between reads, so only a slot whose buffer was handed off draws a new one
+    if (receiveSlot.buffer.isNull()) {
+        receiveSlot.buffer = this->m_datagramBufferPool->acquire();
     }
-    receivedString = std::string{lowLevelReceiveBuffer};
-    if (receivedString.length() > 0) {
-        ioMutexLock.lock();
-        this->m_datagramQueue.emplace_back(receivedAddress, receivedString);
-        ioMutexLock.unlock();
-        if (this->m_isEchoServer) {
-            this->respondTo(&receivedAddress, receivedString);
-        }
+    size_t pooledLength{std::min(receiveSlot.buffer.capacity(), UDPServer::RECEIVED_BUFFER_MAX)};
+    size_t ioVectorCount{0};
+    if (pooledLength > 0) {
+        receiveSlot.ioVectors[ioVectorCount].iov_base = receiveSlot.buffer.data();
+        receiveSlot.ioVectors[ioVectorCount].iov_len = pooledLength;
+        ioVectorCount++;
+    }
+    //Anything past the pooled buffer spills into the overflow area instead of being truncated
+    if (pooledLength < UDPServer::RECEIVED_BUFFER_MAX) {
+        receiveSlot.ioVectors[ioVectorCount].iov_base = overflowBuffer;
+        receiveSlot.ioVectors[ioVectorCount].iov_len = UDPServer::RECEIVED_BUFFER_MAX - pooledLength;
+        ioVectorCount++;
     }
+    receiveSlot.messageHeader = msghdr{};
+    receiveSlot.messageHeader.msg_name = &receiveSlot.address;
+    receiveSlot.messageHeader.msg_namelen = sizeof(sockaddr_in);
+    receiveSlot.messageHeader.msg_iov = receiveSlot.ioVectors;
+    receiveSlot.messageHeader.msg_iovlen = ioVectorCount;
+    if ((this->m_receiveTimestamps) || (this->m_receiveGRO)) {
+        receiveSlot.messageHeader.msg_control = receiveSlot.control.buffer;
+        receiveSlot.messageHeader.msg_controllen = sizeof(receiveSlot.control.buffer);
+    }
+    receiveSlot.receivedLength = 0;
 }
 
-void UDPServer::respondTo(struct sockaddr_in *address, const std::string &receivedString)
+void UDPServer::takeReceivedDatagrams(ReceiveSlot &receiveSlot, const char *overflowBuffer, std::vector<UDPDatagram> &receivedDatagrams)
 {
-    if (!address) {
-        throw std::runtime_error("In UDPServer::respondTo(struct sockaddr_in *, const std::string &): sockaddr_in is a nullptr");
-    }
-    auto udpSocketIndex = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    ssize_t bytesWritten{sendto(udpSocketIndex, 
-                        receivedString.c_str(), 
-                        strlen(receivedString.c_str()),
-                        MSG_DONTWAIT,
-                        reinterpret_cast<sockaddr*>(address),
-                        sizeof(*address)) };
-    /*
-    if ((bytesWritten != -1) && (errno != EAGAIN) && (errno != EWOULDBLOCK))  {
-        return bytesWritten;
+    size_t receivedLength{receiveSlot.receivedLength};
+    if (receivedLength == 0) {
+        return;
     }
-    */
+    size_t pooledLength{std::min<size_t>(receiveSlot.buffer.capacity(), UDPServer::RECEIVED_BUFFER_MAX)};
+    DatagramBuffer receivedBuffer{};
+    if (receivedLength <= pooledLength) {
+        receiveSlot.buffer.setSize(receivedLength);
+        receivedBuffer = std::move(receiveSlot.buffer);
+    } else {
+        //Either the pool was exhausted or the datagram outgrew a pooled buffer, so it gets exact-size heap storage
+        receivedBuffer = DatagramBuffer{receivedLength};
+        if (pooledLength > 0) {
+            memcpy(receivedBuffer.data(), receiveSlot.buffer.data(), pooledLength);
+        } else {
+            this->m_datagramBufferPool->recordExhaustion();
+        }
+        memcpy(receivedBuffer.data() + pooledLength, overflowBuffer, receivedLength - pooledLength);
+        receivedBuffer.setSize(receivedLength);
+    }
+    this->appendReceivedDatagrams(receiveSlot.address, std::move(receivedBuffer), &receiveSlot.messageHeader, receivedDatagrams);
 }
 
-void UDPServer::syncDatagramListener()
+void UDPServer::appendReceivedDatagrams(const sockaddr_in &address, DatagramBuffer &&receivedBuffer, msghdr *messageHeader, std::vector<UDPDatagram> &receivedDatagrams)
 {
-    std::unique_lock<std::mutex> ioMutexLock{this->m_ioMutex, std::defer_lock};
-    char lowLevelReceiveBuffer[UDPServer::RECEIVED_BUFFER_MAX];
-    memset(lowLevelReceiveBuffer, 0, UDPServer::RECEIVED_BUFFER_MAX);
-    std::string receivedString{""};
-    sockaddr_in receivedAddress{};
-    platform_socklen_t socketSize{sizeof(sockaddr)};
-    ssize_t returnValue{recvfrom(this->m_socketNumber,
-                        lowLevelReceiveBuffer,
-                        sizeof(lowLevelReceiveBuffer)-1,
-                        0,
-                        reinterpret_cast<sockaddr *>(&receivedAddress),
-                        &socketSize)};
-    if ((returnValue == EAGAIN) || (returnValue == EWOULDBLOCK) || (returnValue == -1)) {
+    size_t receivedLength{receivedBuffer.size()};
+    std::chrono::system_clock::time_point receiveTimestamp{};
+    size_t segmentSize{0};
+    if ((this->m_receiveTimestamps) || (this->m_receiveGRO)) {
+        readControlMessages(messageHeader, &receiveTimestamp, &segmentSize);
+    }
+    if ((segmentSize == 0) || (segmentSize >= receivedLength)) {
+        receivedDatagrams.emplace_back(address, std::move(receivedBuffer));
+        receivedDatagrams.back().m_receiveTimestamp = receiveTimestamp;
         return;
     }
-    receivedString = std::string{lowLevelReceiveBuffer};
-    if (receivedString.length() > 0) {
-        ioMutexLock.lock();
-        this->m_datagramQueue.emplace_back(receivedAddress, receivedString);
-        ioMutexLock.unlock();
+    //A GRO super-buffer holds equal sized segments with a shorter tail, each becomes a slice of the shared storage
+    std::shared_ptr<DatagramBuffer> sharedStorage{std::make_shared<DatagramBuffer>(std::move(receivedBuffer))};
+    for (size_t offset = 0; offset < receivedLength; offset += segmentSize) {
+        receivedDatagrams.emplace_back(address, DatagramBuffer::slice(sharedStorage, offset, std::min(segmentSize, receivedLength - offset)));
+        receivedDatagrams.back().m_receiveTimestamp = receiveTimestamp;
     }
 }
 
-void UDPServer::setLineEnding(const std::string &lineEnding)
+#if defined(__linux__)
+void UDPServer::takeReceivedMessage(const UDPIoUringMessage &receivedMessage, std::vector<UDPDatagram> &receivedDatagrams)
 {
-    this->m_lineEnding = lineEnding;
+    //The provided buffer goes straight back to the kernel, so the payload is copied out into pool storage
+    DatagramBuffer receivedBuffer{this->m_datagramBufferPool->acquire()};
+    if (receivedMessage.length <= receivedBuffer.capacity()) {
+        memcpy(receivedBuffer.data(), receivedMessage.payload, receivedMessage.length);
+        receivedBuffer.setSize(receivedMessage.length);
+    } else {
+        if (receivedBuffer.isNull()) {
+            this->m_datagramBufferPool->recordExhaustion();
+        }
+        receivedBuffer = DatagramBuffer{receivedMessage.payload, receivedMessage.length};
+    }
+    msghdr controlHeader{receivedMessage.controlHeader};
+    this->appendReceivedDatagrams(receivedMessage.address, std::move(receivedBuffer), &controlHeader, receivedDatagrams);
 }
 
-std::string UDPServer::lineEnding() const
+bool UDPServer::ioUringDatagramListener(int socketNumber, SPSCRingBuffer<UDPDatagram> *datagramRing)
 {
-    return this->m_lineEnding;
+    std::unique_ptr<UDPIoUring> ioUring{nullptr};
+    try {
+        ioUring.reset(new UDPIoUring{});
+        ioUring->startMultishotReceive(socketNumber, UDPServer::RECEIVED_BUFFER_MAX);
+    } catch (std::exception &e) {
+        //Out of locked memory or a sandbox without io_uring, the socket listener takes over
+        (void)e;
+        return false;
+    }
+    std::vector<UDPIoUringMessage> receivedMessages{};
+    std::vector<UDPDatagram> receivedDatagrams{};
+    receivedMessages.reserve(UDPIoUring::DEFAULT_RECEIVE_BUFFER_COUNT);
+    receivedDatagrams.reserve(UDPIoUring::DEFAULT_RECEIVE_BUFFER_COUNT);
+    //The ring wait stands in for SO_RCVTIMEO, it bounds how long stopListening() waits for this thread
+    long waitTimeout{this->m_timeout > 0 ? this->m_timeout : static_cast<long>(UDPServer::DEFAULT_TIMEOUT)};
+    do {
+        bool isReceiveFailed{false};
+        try {
+            if (!ioUring->waitForReceives(receivedMessages, waitTimeout)) {
+                continue;
+            }
+        } catch (std::exception &e) {
+            //Whatever was reaped before the error is still in its provided buffers, so it is delivered first
+            (void)e;
+            isReceiveFailed = true;
+        }
+        receivedDatagrams.clear();
+        for (auto &it : receivedMessages) {
+            this->takeReceivedMessage(it, receivedDatagrams);
+        }
+        ioUring->recycleReceiveBuffers(receivedMessages);
+        if (!receivedDatagrams.empty()) {
+            this->enqueueDatagrams(receivedDatagrams.data(), receivedDatagrams.size(), datagramRing);
+            this->notifyDatagramWaiters();
+        }
+        if (isReceiveFailed) {
+            //A socket error (ECONNREFUSED after an ICMP unreachable, say) ends the multishot receive, so rearm it on a fresh ring
+            try {
+                ioUring.reset(new UDPIoUring{});
+                ioUring->startMultishotReceive(socketNumber, UDPServer::RECEIVED_BUFFER_MAX);
+            } catch (std::exception &e) {
+                (void)e;
+                return false;
+            }
+        }
+    } while (!this->m_shutEmDown);
+    return true;
 }
+#endif
 
-std::string UDPServer::peek()
+ssize_t UDPServer::receiveDatagram(int socketNumber, ReceiveSlot &receiveSlot, int flags)
 {
-    this->syncDatagramListener();
-    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
-    if (this->m_datagramQueue.size() == 0) {
-        return "";
-    } else {
-        return this->m_datagramQueue.front().message();
-    }
+    ssize_t returnValue{recvmsg(socketNumber, &receiveSlot.messageHeader, flags)};
+    receiveSlot.receivedLength = (returnValue > 0 ? static_cast<size_t>(returnValue) : 0);
+    return returnValue;
 }
 
-
-UDPDatagram UDPServer::peekDatagram()
+#if defined(__linux__)
+int UDPServer::receiveDatagramBatch(int socketNumber, std::vector<ReceiveSlot> &receiveSlots, std::vector<mmsghdr> &messageHeaders)
 {
-    this->syncDatagramListener();
-    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
-    if (this->m_datagramQueue.size() == 0) {
-        return UDPDatagram{};
-    } else {
-        return this->m_datagramQueue.front();
+    for (size_t i = 0; i < messageHeaders.size(); i++) {
+        messageHeaders[i].msg_hdr = receiveSlots[i].messageHeader;
+        messageHeaders[i].msg_len = 0;
+    }
+    int returnValue{recvmmsg(socketNumber, messageHeaders.data(), messageHeaders.size(), MSG_DONTWAIT, nullptr)};
+    for (int i = 0; i < returnValue; i++) {
+        receiveSlots[i].messageHeader = messageHeaders[i].msg_hdr;
+        receiveSlots[i].receivedLength = messageHeaders[i].msg_len;
     }
+    return returnValue;
 }
 
-char UDPServer::peekByte()
+void UDPServer::drainDatagrams(int socketNumber, ReceiveOverflowBuffers &overflowBuffers)
 {
-    this->syncDatagramListener();
-    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
-    if (this->m_datagramQueue.size() == 0) {
-        return 0;
-    } else {
-        if (this->m_datagramQueue.front().message().size() == 0) {
-            return 0;
-        } else {
-            return this->m_datagramQueue.front().message().at(0);
+    const size_t batchSize{this->m_reactorReceiveSlots.size()};
+    overflowBuffers.reserve(batchSize);
+    //Bounded so one busy socket cannot starve the others, the level triggered registration brings it straight back
+    size_t drainedCount{0};
+    while (drainedCount < UDPServer::REACTOR_DRAIN_LIMIT) {
+        for (size_t i = 0; i < batchSize; i++) {
+            this->prepareReceiveSlot(this->m_reactorReceiveSlots[i], overflowBuffers.slot(i));
+        }
+        int returnValue{this->receiveDatagramBatch(socketNumber, this->m_reactorReceiveSlots, this->m_reactorMessageHeaders)};
+        if (returnValue <= 0) {
+            return;
+        }
+        size_t receivedCount{static_cast<size_t>(returnValue)};
+        this->m_reactorReceivedDatagrams.clear();
+        for (size_t i = 0; i < receivedCount; i++) {
+            this->takeReceivedDatagrams(this->m_reactorReceiveSlots[i], overflowBuffers.slot(i), this->m_reactorReceivedDatagrams);
+        }
+        if (!this->m_reactorReceivedDatagrams.empty()) {
+            this->enqueueDatagrams(this->m_reactorReceivedDatagrams.data(), this->m_reactorReceivedDatagrams.size());
+            this->notifyDatagramWaiters();
+        }
+        drainedCount += receivedCount;
+        if (receivedCount < batchSize) {
+            return;
         }
     }
 }
+#endif
 
-char UDPServer::readByte()
+void UDPServer::setReactor(UDPReactor *reactor)
 {
-    this->syncDatagramListener();
-    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
-    std::string str{this->m_datagramQueue.front().message()};
-    if (str.length() == 0) {
-        return 0;
+    this->m_reactor = reactor;
+    if (reactor) {
+        this->m_shutEmDown = false;
+        this->m_reactorReceiveSlots = std::vector<ReceiveSlot>(this->m_receiveBatchSize);
+        this->m_reactorReceivedDatagrams.reserve(this->m_receiveBatchSize);
+#if defined(__linux__)
+        this->m_reactorMessageHeaders = std::vector<mmsghdr>(this->m_receiveBatchSize);
+#endif
+        this->m_isListening = true;
+    } else {
+        this->m_isListening = false;
+        this->m_reactorReceiveSlots.clear();
+        this->m_reactorReceivedDatagrams.clear();
+        {
+            std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
+        }
+        this->m_datagramAvailable.notify_all();
     }
-    char charToReturn{str.at(0)};
-    std::string newDatagramMessage{str.substr(1)};
-    struct sockaddr_in newDatagramAddress;
-    newDatagramAddress.sin_family = this->m_datagramQueue.front().socketAddress().sin_family;
-    newDatagramAddress.sin_port = this->m_datagramQueue.front().socketAddress().sin_port;
-    newDatagramAddress.sin_addr.s_addr = this->m_datagramQueue.front().socketAddress().sin_addr.s_addr;
-    this->m_datagramQueue.pop_front();
-    this->m_datagramQueue.emplace_front(newDatagramAddress, newDatagramMessage);
-    return charToReturn;
-
 }
 
-UDPDatagram UDPServer::readDatagram()
+void UDPServer::syncDatagramListener(int socketNumber, int flags)
 {
-    this->syncDatagramListener();
-    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
-    if (this->m_datagramQueue.size() == 0) {
-        return UDPDatagram{};
-    } else {
-        UDPDatagram returnDatagram{this->m_datagramQueue.front()};
-        this->m_datagramQueue.pop_front();
-        return returnDatagram;
+    //The listener thread owns the socket while it runs, consumers only look at the queue
+    if (this->m_isListening) {
+        return;
+    }
+    std::unique_lock<std::mutex> ioMutexLock{this->m_ioMutex, std::defer_lock};
+    if (this->m_datagramRing) {
+        ioMutexLock.lock();
+        //Nobody else drains the ring here, so leave the datagram in the socket unless all of its GRO segments fit
+        size_t requiredSpace{this->m_receiveGRO ? UDPServer::MAXIMUM_GRO_SEGMENTS : 1};
+        if (this->m_datagramRing->size() + requiredSpace > this->m_datagramRing->capacity()) {
+            return;
+        }
+    }
+    char lowLevelOverflowBuffer[UDPServer::RECEIVED_BUFFER_MAX];
+    ReceiveSlot receiveSlot{};
+    this->prepareReceiveSlot(receiveSlot, lowLevelOverflowBuffer);
+    if (this->receiveDatagram(socketNumber, receiveSlot, flags) <= 0) {
+        return;
     }
+    std::vector<UDPDatagram> receivedDatagrams{};
+    this->takeReceivedDatagrams(receiveSlot, lowLevelOverflowBuffer, receivedDatagrams);
+    if (this->m_isEchoServer) {
+        sockaddr_in receivedAddress{receiveSlot.address};
+        for (auto &it : receivedDatagrams) {
+            this->respondTo(&receivedAddress, it.data(), it.size());
+        }
+    }
+    this->enqueueDatagrams(receivedDatagrams.data(), receivedDatagrams.size());
 }
 
+void UDPServer::enqueueDatagrams(UDPDatagram *datagrams, size_t count)
+{
+    return this->enqueueDatagrams(datagrams, count, this->m_datagramRing.get());
+}
 
-std::string UDPServer::readLine()
+void UDPServer::enqueueDatagrams(UDPDatagram *datagrams, size_t count, SPSCRingBuffer<UDPDatagram> *datagramRing)
 {
-    this->syncDatagramListener();
-    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
-    if (this->m_datagramQueue.size() == 0) {
-        return "";
+    if (this->m_datagramHandler) {
+        //Handled where it was received, with no lock, copy or wakeup, and the pooled payload goes back once the batch is done
+        for (size_t i = 0; i < count; i++) {
+            this->m_datagramHandler(UDPDatagramView{datagrams[i]});
+        }
+        return;
+    }
+    if (this->m_receiveTimestamps) {
+        std::chrono::system_clock::time_point queueTimestamp{std::chrono::system_clock::now()};
+        for (size_t i = 0; i < count; i++) {
+            datagrams[i].m_queueTimestamp = queueTimestamp;
+        }
+    }
+    if (datagramRing) {
+        for (size_t i = 0; i < count; i++) {
+            size_t length{datagrams[i].size()};
+            if (!this->makeReceiveRingRoom(datagramRing, length)) {
+                this->recordDroppedDatagram(length);
+                continue;
+            }
+            this->m_queuedByteCount += length;
+            //A full ring leaves the backlog in the socket buffer until the consumer catches up
+            while (!datagramRing->tryPush(std::move(datagrams[i]))) {
+                if (this->m_shutEmDown) {
+                    this->m_queuedByteCount -= length;
+                    for (; i < count; i++) {
+                        this->recordDroppedDatagram(datagrams[i].size());
+                    }
+                    return;
+                }
+                std::this_thread::yield();
+            }
+        }
+    } else if (count > 0) {
+        std::unique_lock<std::mutex> ioMutexLock{this->m_ioMutex};
+        for (size_t i = 0; i < count; i++) {
+            size_t length{datagrams[i].size()};
+            if (!this->makeReceiveQueueRoom(length, ioMutexLock)) {
+                this->recordDroppedDatagram(length);
+                continue;
+            }
+            this->m_queuedByteCount += length;
+            this->m_datagramQueue.push_back(std::move(datagrams[i]));
+        }
     }
-    std::string stringToReturn{this->m_datagramQueue.front().message()};
-    this->m_datagramQueue.pop_front();
-    return stringToReturn;
 }
 
-void UDPServer::openPort()
+bool UDPServer::isReceiveQueueFull(size_t queuedCount, size_t length) const
 {
-    //this->startListening();
+    size_t datagramLimit{this->m_receiveQueueDatagramLimit};
+    size_t byteLimit{this->m_receiveQueueByteLimit};
+    return (((datagramLimit != 0) && (queuedCount >= datagramLimit)) ||
+            ((byteLimit != 0) && (this->m_queuedByteCount + length > byteLimit)));
 }
 
-void UDPServer::closePort()
+bool UDPServer::makeReceiveQueueRoom(size_t length, std::unique_lock<std::mutex> &ioMutexLock)
 {
-    //this->stopListening();
+    //Returns false when the incoming datagram is the one to drop
+    size_t byteLimit{this->m_receiveQueueByteLimit};
+    if ((byteLimit != 0) && (length > byteLimit)) {
+        return false;
+    }
+    while (this->isReceiveQueueFull(this->m_datagramQueue.size(), length)) {
+        ReceiveQueuePolicy receiveQueuePolicy{this->m_receiveQueuePolicy};
+        if (receiveQueuePolicy == ReceiveQueuePolicy::DropOldest) {
+            //A partly read front datagram holds a reader's cursor and maybe the UDPLineView it was handed, so it is never evicted
+            size_t oldestIndex{(this->m_frontReadOffset != 0) ? 1U : 0U};
+            if (this->m_datagramQueue.size() <= oldestIndex) {
+                return false;
+            }
+            size_t oldestSize{this->m_datagramQueue[oldestIndex].size()};
+            this->recordDroppedDatagram(oldestSize);
+            this->m_queuedByteCount -= oldestSize;
+            this->m_datagramQueue.erase(this->m_datagramQueue.begin() + oldestIndex);
+            //A streaming line search may have counted the evicted datagram already, so it starts over
+            this->m_frontGeneration++;
+        } else if ((receiveQueuePolicy == ReceiveQueuePolicy::DropNewest) || (!this->m_isListening) || (this->m_reactor)) {
+            //A synchronous read would wait on itself and a reactor thread serves other servers too, so neither blocks
+            return false;
+        } else {
+            if (this->m_shutEmDown) {
+                return false;
+            }
+            this->m_datagramAvailable.notify_all();
+            //Polled as well, a reactor detach or a policy change does not signal the listener
+            this->m_receiveQueueSpace.wait_for(ioMutexLock, std::chrono::milliseconds(100));
+        }
+    }
+    return true;
 }
 
-bool UDPServer::isOpen() const
+bool UDPServer::makeReceiveRingRoom(SPSCRingBuffer<UDPDatagram> *datagramRing, size_t length)
 {
-    return this->m_isListening;
+    size_t byteLimit{this->m_receiveQueueByteLimit};
+    if ((byteLimit != 0) && (length > byteLimit)) {
+        return false;
+    }
+    while (this->isReceiveQueueFull(datagramRing->size(), length)) {
+        if ((this->m_receiveQueuePolicy != ReceiveQueuePolicy::BlockListener) || (!this->m_isListening) || (this->m_reactor) || (this->m_shutEmDown)) {
+            return false;
+        }
+        this->notifyDatagramWaiters();
+        std::this_thread::yield();
+    }
+    //A reactor thread serves other sockets too, so it drops what the ring cannot take rather than waiting in tryPush()
+    if ((this->m_reactor) && (datagramRing->size() >= datagramRing->capacity())) {
+        return false;
+    }
+    return true;
 }
 
-std::string UDPServer::readUntil(char until)
+void UDPServer::recordDroppedDatagram(size_t length)
 {
-    return this->readUntil(std::string{1, until});
+    this->m_droppedDatagramCount.fetch_add(1, std::memory_order_relaxed);
+    this->m_droppedByteCount.fetch_add(length, std::memory_order_relaxed);
 }
 
-std::string UDPServer::readUntil(const char *until)
+void UDPServer::awaitDatagram(int socketNumber)
 {
-    return this->readUntil(static_cast<std::string>(until));
+    //Blocking reads honour the timeout whether the listener thread or SO_RCVTIMEO does the waiting
+    if (this->m_isListening) {
+        this->waitForDatagram(socketNumber, std::chrono::milliseconds{this->m_timeout});
+    } else {
+        this->syncDatagramListener(socketNumber);
+    }
 }
 
-std::string UDPServer::readUntil(const std::string &until)
+void UDPServer::notifyDatagramWaiters()
 {
-    std::string tempLineEnding{this->m_lineEnding};
-    this->m_lineEnding = until;
-    std::string returnString{this->readLine()};
-    this->m_lineEnding = tempLineEnding;
-    return returnString;
+    //Pairs with the fence in waitForDatagram(), so either the waiter sees the datagram or the listener sees the waiter
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (this->m_datagramWaiterCount.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
+    }
+    this->m_datagramAvailable.notify_all();
 }
 
-void UDPServer::putBack(const UDPDatagram &datagram)
+UDPDatagram *UDPServer::frontDatagram()
 {
-    std::lock_guard<std::mutex> ioMutex{this->m_ioMutex};
-    this->m_datagramQueue.push_front(datagram);
+    if (!this->m_datagramQueue.empty()) {
+        return &this->m_datagramQueue.front();
+    }
+    return this->frontRingDatagram();
 }
 
-void UDPServer::putBack(char back)
+UDPDatagram *UDPServer::frontRingDatagram()
 {
-    return UDPServer::putBack(std::string{1, back});
+    UDPDatagram *frontDatagram{this->m_datagramRing ? this->m_datagramRing->front() : nullptr};
+    if (frontDatagram) {
+        return frontDatagram;
+    }
+    return this->frontShardDatagram();
 }
 
-void UDPServer::putBack(const char *str)
+UDPDatagram *UDPServer::frontShardDatagram()
 {
-    return UDPServer::putBack(static_cast<std::string>(str));
+    //Round robin across the shards, ordering only holds per shard and therefore per peer
+    for (size_t i = 0; i < this->m_receiveShards.size(); i++) {
+        size_t shardIndex{(this->m_nextShard + i) % this->m_receiveShards.size()};
+        UDPDatagram *frontDatagram{this->m_receiveShards[shardIndex].datagramRing->front()};
+        if (frontDatagram) {
+            this->m_frontShard = shardIndex;
+            return frontDatagram;
+        }
+    }
+    return nullptr;
 }
 
-void UDPServer::putBack(const std::string &str)
+void UDPServer::popDatagram()
 {
-    if (str.length() == 0) {
-        return;
+    this->m_frontGeneration++;
+    if (!this->m_datagramQueue.empty()) {
+        //Whoever moved the payload out has already taken its bytes off the count
+        this->m_queuedByteCount -= this->m_datagramQueue.front().size();
+        this->m_datagramQueue.pop_front();
+        this->m_frontReadOffset = 0;
+        if (this->m_receiveQueuePolicy == ReceiveQueuePolicy::BlockListener) {
+            this->m_receiveQueueSpace.notify_all();
+        }
+    } else {
+        this->popRingDatagram();
     }
-    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
-    std::string newDatagramMessage{str + this->m_datagramQueue.front().message()};
-    struct sockaddr_in newDatagramAddress;
-    newDatagramAddress.sin_family = this->m_datagramQueue.front().socketAddress().sin_family;
-    newDatagramAddress.sin_port = this->m_datagramQueue.front().socketAddress().sin_port;
-    newDatagramAddress.sin_addr.s_addr = this->m_datagramQueue.front().socketAddress().sin_addr.s_addr;
-    this->m_datagramQueue.pop_front();
-    this->m_datagramQueue.emplace_front(newDatagramAddress, newDatagramMessage);
 }
 
-uint16_t UDPServer::doUserSelectPortNumber()
+void UDPServer::popRingDatagram()
 {
-    return doUserEnterNumericParameter("Server Port Number",
-                                                         static_cast<std::function<bool(uint16_t)>>(UDPServer::isValidPortNumber),
-                                                         std::numeric_limits<uint16_t>::min()+1,
-                                                         std::numeric_limits<uint16_t>::max());
+    if ((this->m_datagramRing) && (this->m_datagramRing->front())) {
+        this->m_queuedByteCount -= this->m_datagramRing->front()->size();
+        this->m_datagramRing->pop();
+    } else if (!this->m_receiveShards.empty()) {
+        //Pop the shard the caller last looked at, an earlier shard may have filled up since
+        if ((this->m_frontShard >= this->m_receiveShards.size()) || (!this->m_receiveShards[this->m_frontShard].datagramRing->front())) {
+            if (!this->frontShardDatagram()) {
+                return;
+            }
+        }
+        this->m_queuedByteCount -= this->m_receiveShards[this->m_frontShard].datagramRing->front()->size();
+        this->m_receiveShards[this->m_frontShard].datagramRing->pop();
+        this->m_nextShard = (this->m_frontShard + 1) % this->m_receiveShards.size();
+    }
 }
 
-std::shared_ptr<UDPServer> UDPServer::doUserSelectUDPServer()
+bool UDPServer::pullRingDatagram()
 {
-    uint16_t portNumber{UDPServer::doUserSelectPortNumber()};
-    return std::make_shared<UDPServer>(portNumber);
+    //Moves the next datagram from the ring or the shards to the back of the deque, where it can be looked past
+    UDPDatagram *nextDatagram{this->frontRingDatagram()};
+    if (!nextDatagram) {
+        return false;
+    }
+    this->m_datagramQueue.push_back(std::move(*nextDatagram));
+    this->popRingDatagram();
+    return true;
 }
 
-std::string UDPServer::readUntil(int socketNumber, char until)
+size_t UDPServer::queuedDatagramCount() const
 {
-    return this->readUntil(socketNumber, std::string{1, until});
+    size_t queuedCount{this->m_datagramQueue.size() + (this->m_datagramRing ? this->m_datagramRing->size() : 0)};
+    for (auto &it : this->m_receiveShards) {
+        queuedCount += it.datagramRing->size();
+    }
+    if ((queuedCount == 0) && (!this->m_putBackBytes.empty())) {
+        //Bytes put back with nothing queued read like a datagram of their own
+        queuedCount = 1;
+    }
+    return queuedCount;
 }
 
-std::string UDPServer::readUntil(int socketNumber, const char *until)
+bool UDPServer::hasUnreadBytes() const
 {
-    return this->readUntil(socketNumber, static_cast<std::string>(until));
+    //Both members are written under m_ioMutex, so the caller holds it
+    return ((this->m_frontReadOffset != 0) || (!this->m_putBackBytes.empty()));
 }
 
-std::string UDPServer::readUntil(int socketNumber, const std::string &until)
+void UDPServer::settleFrontDatagram()
 {
-    std::string tempLineEnding{this->m_lineEnding};
-    this->m_lineEnding = until;
-    std::string returnString{this->readLine(socketNumber)};
-    this->m_lineEnding = tempLineEnding;
-    return returnString;
+    //Whole datagram reads want the put back bytes and the rest of the front datagram as one datagram again
+    if (!this->hasUnreadBytes()) {
+        return;
+    }
+    std::string newDatagramMessage{this->m_putBackBytes.rbegin(), this->m_putBackBytes.rend()};
+    struct sockaddr_in newDatagramAddress{};
+    this->m_putBackBytes.clear();
+    UDPDatagram *frontDatagram{this->frontDatagram()};
+    if (frontDatagram) {
+        newDatagramMessage.append(frontDatagram->data() + this->m_frontReadOffset, frontDatagram->size() - this->m_frontReadOffset);
+        newDatagramAddress = frontDatagram->socketAddress();
+        this->popDatagram();
+    }
+    this->m_datagramQueue.emplace_front(newDatagramAddress, newDatagramMessage);
+    this->m_queuedByteCount += newDatagramMessage.size();
+    this->m_frontGeneration++;
+}
+
+void UDPServer::clearQueuedDatagrams()
+{
+    this->m_frontReadOffset = 0;
+    this->m_putBackBytes.clear();
+    //Popped one at a time to keep the queued byte count right, and only what is queued now while a listener keeps adding
+    for (size_t queuedCount = this->queuedDatagramCount(); (queuedCount > 0) && (this->frontDatagram()); queuedCount--) {
+        this->popDatagram();
+    }
+    this->m_frontGeneration++;
+}
+
+void UDPServer::setReceiveShards(size_t shardCount, bool pinShardsToCpus, size_t shardQueueCapacity)
+{
+#if defined(__linux__)
+    if (this->m_isListening) {
+        throw std::runtime_error("In UDPServer::setReceiveShards(size_t, bool, size_t): The receive shards cannot be changed while the server is listening");
+    }
+    if ((shardCount == 0) || (shardCount > UDPServer::MAXIMUM_RECEIVE_SHARD_COUNT)) {
+        throw std::runtime_error("In UDPServer::setReceiveShards(size_t, bool, size_t): Invalid shard count, must be between 1 and " +
+                                 std::to_string(UDPServer::MAXIMUM_RECEIVE_SHARD_COUNT)
+                                 + " ("
+                                 + std::to_string(shardCount)
+                                 + ")");
+    }
+    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
+    for (auto &it : this->m_receiveShards) {
+        UDPDatagram datagram{};
+        while (it.datagramRing->tryPop(datagram)) {
+            this->m_datagramQueue.push_back(std::move(datagram));
+        }
+        if (it.socketNumber != this->m_socketNumber) {
+            close(it.socketNumber);
+        }
+    }
+    this->m_receiveShards.clear();
+    this->m_pinReceiveShards = pinShardsToCpus;
+    this->m_frontShard = 0;
+    this->m_nextShard = 0;
+    if (shardCount == 1) {
+        return;
+    }
+    //Every socket in a SO_REUSEPORT group needs the option before it binds, so the original socket is rebound as shard 0
+    close(this->m_socketNumber);
+    for (size_t i = 0; i < shardCount; i++) {
+        ReceiveShard receiveShard{};
+        receiveShard.socketNumber = this->openReusePortSocket();
+        receiveShard.datagramRing = std::unique_ptr<SPSCRingBuffer<UDPDatagram>>{new SPSCRingBuffer<UDPDatagram>{shardQueueCapacity}};
+        this->m_receiveShards.push_back(std::move(receiveShard));
+    }
+    this->m_socketNumber = this->m_receiveShards.front().socketNumber;
+    //Without the program the kernel's own 4-tuple hash still keeps each peer on one shard
+    attachReusePortSteering(this->m_socketNumber, shardCount);
+#else
+    (void)pinShardsToCpus;
+    (void)shardQueueCapacity;
+    if (shardCount != 1) {
+        throw std::runtime_error("In UDPServer::setReceiveShards(size_t, bool, size_t): Receive sharding requires SO_REUSEPORT, which is only supported on Linux");
+    }
+#endif
+}
+
+size_t UDPServer::receiveShardCount() const
+{
+    return std::max<size_t>(this->m_receiveShards.size(), 1);
+}
+
+int UDPServer::openReusePortSocket()
+{
+    int socketNumber{socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)};
+    if (socketNumber == -1) {
+        throw std::runtime_error("ERROR: UDPServer could not open a receive shard socket");
+    }
+    int reusePort{1};
+    if ((setsockopt(socketNumber, SOL_SOCKET, SO_REUSEPORT, &reusePort, sizeof(reusePort)) == -1) ||
+        (bind(socketNumber, reinterpret_cast<sockaddr *>(&this->m_socketAddress), sizeof(sockaddr)) == -1)) {
+        close(socketNumber);
+        throw std::runtime_error("ERROR: UDPServer could not bind receive shard socket to address " + tQuoted(toStdString(this->m_socketAddress)) + " (is something else using it?)");
+    }
+    this->setTimeout(socketNumber, this->m_timeout);
+    if (this->m_receiveTimestamps) {
+        this->enableReceiveTimestamps(socketNumber);
+    }
+    if (this->m_receiveGRO) {
+        this->enableReceiveGRO(socketNumber, true);
+    }
+    return socketNumber;
+}
+
+void UDPServer::setReceiveGRO(bool receiveGRO)
+{
+    if (this->m_isListening) {
+        throw std::runtime_error("In UDPServer::setReceiveGRO(bool): UDP GRO cannot be changed while the server is listening");
+    }
+    this->enableReceiveGRO(this->m_socketNumber, receiveGRO);
+    for (auto &it : this->m_receiveShards) {
+        if (it.socketNumber != this->m_socketNumber) {
+            this->enableReceiveGRO(it.socketNumber, receiveGRO);
+        }
+    }
+    this->m_receiveGRO = receiveGRO;
+    //Coalesced super-buffers only split without copying when a whole one fits in a pooled buffer
+    if ((receiveGRO) && (this->m_datagramBufferPool->bufferSize() < UDPServer::RECEIVED_BUFFER_MAX)) {
+        this->m_datagramBufferPool = DatagramBufferPool::create(UDPServer::RECEIVED_BUFFER_MAX, UDPServer::DEFAULT_GRO_POOL_BUFFER_COUNT);
+    }
+}
+
+bool UDPServer::receiveGRO() const
+{
+    return this->m_receiveGRO;
+}
+
+void UDPServer::enableReceiveGRO(int socketNumber, bool receiveGRO)
+{
+#if defined(__linux__) && defined(UDP_GRO)
+    int enableGRO{receiveGRO ? 1 : 0};
+    if (setsockopt(socketNumber, SOL_UDP, UDP_GRO, &enableGRO, sizeof(enableGRO)) == 0) {
+        return;
+    }
+#endif
+    if (receiveGRO) {
+        throw std::runtime_error("In UDPServer::enableReceiveGRO(int, bool): UDP GRO is not supported on socket " + std::to_string(socketNumber));
+    }
+}
+
+void UDPServer::setReceiveTimestamps(bool receiveTimestamps)
+{
+    if (this->m_isListening) {
+        throw std::runtime_error("In UDPServer::setReceiveTimestamps(bool): Receive timestamps cannot be changed while the server is listening");
+    }
+    this->m_receiveTimestamps = receiveTimestamps;
+    if (!receiveTimestamps) {
+        return;
+    }
+    this->enableReceiveTimestamps(this->m_socketNumber);
+    for (auto &it : this->m_receiveShards) {
+        if (it.socketNumber != this->m_socketNumber) {
+            this->enableReceiveTimestamps(it.socketNumber);
+        }
+    }
+}
+
+bool UDPServer::receiveTimestamps() const
+{
+    return this->m_receiveTimestamps;
+}
+
+void UDPServer::enableReceiveTimestamps(int socketNumber)
+{
+#if defined(__linux__)
+    //Prefer SO_TIMESTAMPING software RX stamps, older kernels only offer SO_TIMESTAMPNS
+    int timestampingFlags{SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE};
+    if (setsockopt(socketNumber, SOL_SOCKET, SO_TIMESTAMPING, &timestampingFlags, sizeof(timestampingFlags)) == 0) {
+        return;
+    }
+    int enableTimestamps{1};
+    if (setsockopt(socketNumber, SOL_SOCKET, SO_TIMESTAMPNS, &enableTimestamps, sizeof(enableTimestamps)) == 0) {
+        return;
+    }
+#endif
+    this->m_receiveTimestamps = false;
+    throw std::runtime_error("In UDPServer::enableReceiveTimestamps(int): Kernel receive timestamps are not supported on socket " + std::to_string(socketNumber));
+}
+
+void UDPServer::startReceiveShards()
+{
+    unsigned int cpuCount{std::max(std::thread::hardware_concurrency(), 1u)};
+    for (size_t i = 0; i < this->m_receiveShards.size(); i++) {
+        ReceiveShard &receiveShard = this->m_receiveShards[i];
+        receiveShard.listenerThread = std::thread{static_cast<void (UDPServer::*)(int, SPSCRingBuffer<UDPDatagram> *)>(&UDPServer::asyncDatagramListener),
+                                                  this,
+                                                  receiveShard.socketNumber,
+                                                  receiveShard.datagramRing.get()};
+#if defined(__linux__)
+        if (this->m_pinReceiveShards) {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            CPU_SET(i % cpuCount, &cpuSet);
+            pthread_setaffinity_np(receiveShard.listenerThread.native_handle(), sizeof(cpu_set_t), &cpuSet);
+        }
+#endif
+    }
+}
+
+void UDPServer::stopReceiveShards()
+{
+    for (auto &it : this->m_receiveShards) {
+        if (it.listenerThread.joinable()) {
+            it.listenerThread.join();
+        }
+    }
+}
+
+void UDPServer::respondTo(struct sockaddr_in *address, const char *data, size_t length)
+{
+    if (!address) {
+        throw std::runtime_error("In UDPServer::respondTo(struct sockaddr_in *, const char *, size_t): sockaddr_in is a nullptr");
+    }
+    //Reply from the bound socket so the peer sees the response come from the port it sent to
+    sendto(this->m_socketNumber,
+           data,
+           length,
+           MSG_DONTWAIT,
+           reinterpret_cast<sockaddr*>(address),
+           sizeof(*address));
+}
+
+void UDPServer::syncDatagramListener()
+{
+    return this->syncDatagramListener(this->m_socketNumber);
+}
+
+void UDPServer::setLineEnding(const std::string &lineEnding)
+{
+    this->m_lineEnding = lineEnding;
+}
+
+std::string UDPServer::lineEnding() const
+{
+    return this->m_lineEnding;
+}
+
+std::string UDPServer::peek()
+{
+    return this->peek(this->m_socketNumber);
+}
+
+
+UDPDatagram UDPServer::peekDatagram()
+{
+    return this->peekDatagram(this->m_socketNumber);
+}
+
+char UDPServer::peekByte()
+{
+    return this->peekByte(this->m_socketNumber);
+}
+
+char UDPServer::readByte()
+{
+    return this->readByte(this->m_socketNumber);
+}
+
+UDPDatagram UDPServer::readDatagram()
+{
+    return this->readDatagram(this->m_socketNumber);
+}
+
+ssize_t UDPServer::readDatagramInto(void *buffer, size_t length)
+{
+    return this->readDatagramInto(this->m_socketNumber, buffer, length);
+}
+
+
+std::string UDPServer::readLine()
+{
+    return this->readLine(this->m_socketNumber);
+}
+
+void UDPServer::openPort()
+{
+    //this->startListening();
+}
+
+void UDPServer::closePort()
+{
+    //this->stopListening();
+}
+
+bool UDPServer::isOpen() const
+{
+    return this->m_isListening;
+}
+
+std::string UDPServer::readUntil(char until)
+{
+    return this->readUntil(std::string(1, until));
+}
+
+std::string UDPServer::readUntil(const char *until)
+{
+    return this->readUntil(static_cast<std::string>(until));
+}
+
+std::string UDPServer::readUntil(const std::string &until)
+{
+    return this->readUntil(this->m_socketNumber, until);
+}
+
+UDPLineView UDPServer::readLineView()
+{
+    return this->readLineView(this->m_socketNumber);
+}
+
+UDPLineView UDPServer::readUntilView(const std::string &until)
+{
+    return this->readUntilView(this->m_socketNumber, until);
+}
+
+void UDPServer::setStreamingLines(bool streamingLines)
+{
+    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
+    this->m_streamingLines = streamingLines;
+}
+
+bool UDPServer::streamingLines() const
+{
+    return this->m_streamingLines;
+}
+
+void UDPServer::installDatagramHandler(UDPDatagramHandler &&datagramHandler)
+{
+    if (this->m_isListening) {
+        throw std::runtime_error("In UDPServer::setDatagramHandler(Handler): The datagram handler cannot be changed while the server is listening");
+    }
+    this->m_datagramHandler = std::move(datagramHandler);
+}
+
+void UDPServer::clearDatagramHandler()
+{
+    return this->installDatagramHandler(UDPDatagramHandler{});
+}
+
+bool UDPServer::hasDatagramHandler() const
+{
+    return static_cast<bool>(this->m_datagramHandler);
+}
+
+void UDPServer::setReceiveQueueLimit(size_t maximumDatagramCount, size_t maximumByteCount)
+{
+    {
+        std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
+        this->m_receiveQueueDatagramLimit = maximumDatagramCount;
+        this->m_receiveQueueByteLimit = maximumByteCount;
+    }
+    this->m_receiveQueueSpace.notify_all();
+}
+
+size_t UDPServer::receiveQueueDatagramLimit() const
+{
+    return this->m_receiveQueueDatagramLimit;
+}
+
+size_t UDPServer::receiveQueueByteLimit() const
+{
+    return this->m_receiveQueueByteLimit;
+}
+
+void UDPServer::setReceiveQueuePolicy(ReceiveQueuePolicy receiveQueuePolicy)
+{
+    {
+        std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
+        this->m_receiveQueuePolicy = receiveQueuePolicy;
+    }
+    this->m_receiveQueueSpace.notify_all();
+}
+
+ReceiveQueuePolicy UDPServer::receiveQueuePolicy() const
+{
+    return this->m_receiveQueuePolicy;
+}
+
+size_t UDPServer::queuedByteCount() const
+{
+    return this->m_queuedByteCount;
+}
+
+uint64_t UDPServer::droppedDatagramCount() const
+{
+    return this->m_droppedDatagramCount;
+}
+
+uint64_t UDPServer::droppedByteCount() const
+{
+    return this->m_droppedByteCount;
+}
+
+void UDPServer::putBack(const UDPDatagram &datagram)
+{
+    std::lock_guard<std::mutex> ioMutex{this->m_ioMutex};
+    this->settleFrontDatagram();
+    this->m_datagramQueue.push_front(datagram);
+    this->m_queuedByteCount += datagram.size();
+    this->m_frontGeneration++;
+}
+
+void UDPServer::putBack(char back)
+{
+    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
+    this->m_putBackBytes.push_back(back);
+}
+
+void UDPServer::putBack(const char *str)
+{
+    return UDPServer::putBack(static_cast<std::string>(str));
+}
+
+void UDPServer::putBack(const std::string &str)
+{
+    if (str.length() == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
+    //Reversed, so the first character of str is on top and is read first
+    this->m_putBackBytes.append(str.rbegin(), str.rend());
+}
+
+uint16_t UDPServer::doUserSelectPortNumber()
+{
+    return doUserEnterNumericParameter("Server Port Number",
+                                                         static_cast<std::function<bool(uint16_t)>>(UDPServer::isValidPortNumber),
+                                                         std::numeric_limits<uint16_t>::min()+1,
+                                                         std::numeric_limits<uint16_t>::max());
+}
+
+std::shared_ptr<UDPServer> UDPServer::doUserSelectUDPServer()
+{
+    uint16_t portNumber{UDPServer::doUserSelectPortNumber()};
+    return std::make_shared<UDPServer>(portNumber);
+}
+
+std::string UDPServer::readUntil(int socketNumber, char until)
+{
+    return this->readUntil(socketNumber, std::string(1, until));
+}
+
+std::string UDPServer::readUntil(int socketNumber, const char *until)
+{
+    return this->readUntil(socketNumber, static_cast<std::string>(until));
+}
+
+std::string UDPServer::readUntil(int socketNumber, const std::string &until)
+{
+    std::unique_lock<std::mutex> ioMutexLock{this->m_ioMutex, std::defer_lock};
+    UDPLineView line{};
+    this->awaitLine(socketNumber, until, ioMutexLock, &line);
+    //Copied before the lock is released, the next read on any thread gives up the storage behind the view
+    return line.toString();
 }
 
 std::string UDPServer::peek(int socketNumber)
 {
     this->syncDatagramListener(socketNumber);
     std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
-    if (this->m_datagramQueue.size() == 0) {
+    this->settleFrontDatagram();
+    UDPDatagram *frontDatagram{this->frontDatagram()};
+    if (!frontDatagram) {
         return "";
     } else {
-        return this->m_datagramQueue.front().message();
+        return frontDatagram->message();
     }
 }
 
@@ -747,99 +1640,395 @@ bool UDPServer::isEchoServer() const
     return this->m_isEchoServer;
 }
 
+void UDPServer::setReceiveBatchSize(size_t receiveBatchSize)
+{
+    if ((receiveBatchSize == 0) || (receiveBatchSize > UDPServer::MAXIMUM_RECEIVE_BATCH_SIZE)) {
+        throw std::runtime_error("In UDPServer::setReceiveBatchSize(size_t): Invalid receive batch size, must be between 1 and " +
+                                 std::to_string(UDPServer::MAXIMUM_RECEIVE_BATCH_SIZE)
+                                 + " ("
+                                 + std::to_string(receiveBatchSize)
+                                 + ")");
+    }
+    this->m_receiveBatchSize = receiveBatchSize;
+}
+
+size_t UDPServer::receiveBatchSize() const
+{
+    return this->m_receiveBatchSize;
+}
+
+void UDPServer::setDatagramQueueType(DatagramQueueType datagramQueueType, size_t ringBufferCapacity)
+{
+    if (this->m_isListening) {
+        throw std::runtime_error("In UDPServer::setDatagramQueueType(DatagramQueueType, size_t): The datagram queue type cannot be changed while the server is listening");
+    }
+    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
+    if (this->m_datagramRing) {
+        UDPDatagram datagram{};
+        while (this->m_datagramRing->tryPop(datagram)) {
+            this->m_datagramQueue.push_back(std::move(datagram));
+        }
+        this->m_datagramRing.reset();
+    }
+    if (datagramQueueType == DatagramQueueType::RingBuffer) {
+        //Anything left in the deque is read before the ring, so ordering is preserved
+        this->m_datagramRing = std::unique_ptr<SPSCRingBuffer<UDPDatagram>>{new SPSCRingBuffer<UDPDatagram>{ringBufferCapacity}};
+    }
+}
+
+DatagramQueueType UDPServer::datagramQueueType() const
+{
+    return (this->m_datagramRing ? DatagramQueueType::RingBuffer : DatagramQueueType::Deque);
+}
+
+void UDPServer::setDatagramBufferPool(size_t bufferSize, size_t maximumBufferCount)
+{
+    if (this->m_isListening) {
+        throw std::runtime_error("In UDPServer::setDatagramBufferPool(size_t, size_t): The datagram buffer pool cannot be changed while the server is listening");
+    }
+    //Datagrams still holding buffers from the old pool keep it alive until they are released
+    this->m_datagramBufferPool = DatagramBufferPool::create(bufferSize, maximumBufferCount);
+}
+
+DatagramBufferPoolStatistics UDPServer::datagramBufferPoolStatistics() const
+{
+    return this->m_datagramBufferPool->statistics();
+}
+
 UDPDatagram UDPServer::peekDatagram(int socketNumber)
 {
     this->syncDatagramListener(socketNumber);
     std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
-    if (this->m_datagramQueue.size() == 0) {
+    this->settleFrontDatagram();
+    UDPDatagram *frontDatagram{this->frontDatagram()};
+    if (!frontDatagram) {
         return UDPDatagram{};
     } else {
-        return this->m_datagramQueue.front();
+        return *frontDatagram;
     }
 }
 
 char UDPServer::peekByte(int socketNumber)
 {
-    this->syncDatagramListener(socketNumber);
-    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
-    if (this->m_datagramQueue.size() == 0) {
+    std::unique_lock<std::mutex> ioMutexLock{this->m_ioMutex};
+    if (!this->hasUnreadBytes()) {
+        ioMutexLock.unlock();
+        this->syncDatagramListener(socketNumber);
+        ioMutexLock.lock();
+    }
+    if (!this->m_putBackBytes.empty()) {
+        return this->m_putBackBytes.back();
+    }
+    UDPDatagram *frontDatagram{this->frontDatagram()};
+    if ((!frontDatagram) || (frontDatagram->size() == 0)) {
         return 0;
     } else {
-        if (this->m_datagramQueue.front().message().size() == 0) {
-            return 0;
-        } else {
-            return this->m_datagramQueue.front().message().at(0);
-        }
+        return frontDatagram->data()[this->m_frontReadOffset];
     }
 }
 
-ssize_t UDPServer::available() 
+ssize_t UDPServer::available()
 {
-    this->syncDatagramListener();
-    return this->m_datagramQueue.size();
+    return this->available(this->m_socketNumber);
 }
 
-ssize_t UDPServer::available(int socketNumber) 
+ssize_t UDPServer::available(int socketNumber)
 {
-    this->syncDatagramListener(socketNumber);
-    return this->m_datagramQueue.size();
+    this->syncDatagramListener(socketNumber, MSG_DONTWAIT);
+    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
+    return this->queuedDatagramCount();
+}
+
+bool UDPServer::waitForDatagram(std::chrono::nanoseconds timeout)
+{
+    return this->waitForDatagram(this->m_socketNumber, timeout);
+}
+
+bool UDPServer::waitForDatagram(int socketNumber, std::chrono::nanoseconds timeout)
+{
+    if (!this->m_isListening) {
+        if (this->available(socketNumber) > 0) {
+            return true;
+        }
+        //Without a listener there is nobody to signal, so let the kernel do the waiting
+        long long timeoutMilliseconds{std::chrono::duration_cast<std::chrono::milliseconds>(timeout).count()};
+        if ((timeoutMilliseconds == 0) && (timeout.count() > 0)) {
+            timeoutMilliseconds = 1;
+        }
+        timeoutMilliseconds = std::min<long long>(std::max<long long>(timeoutMilliseconds, 0), std::numeric_limits<int>::max());
+        pollfd pollDescriptor{};
+        pollDescriptor.fd = socketNumber;
+        pollDescriptor.events = POLLIN;
+        if (poll(&pollDescriptor, 1, static_cast<int>(timeoutMilliseconds)) <= 0) {
+            return false;
+        }
+        return (this->available(socketNumber) > 0);
+    }
+    this->m_datagramWaiterCount.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::unique_lock<std::mutex> ioMutexLock{this->m_ioMutex};
+    bool datagramAvailable{this->m_datagramAvailable.wait_for(ioMutexLock, timeout, [this]() {
+        return ((this->queuedDatagramCount() > 0) || (!this->m_isListening));
+    })};
+    this->m_datagramWaiterCount.fetch_sub(1);
+    return (datagramAvailable && (this->queuedDatagramCount() > 0));
 }
 
 char UDPServer::readByte(int socketNumber)
 {
-    this->syncDatagramListener(socketNumber);
-    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
-    std::string str{this->m_datagramQueue.front().message()};
-    if (str.length() == 0) {
+    //A partly read datagram or put back bytes are already here, so there is nothing to wait for
+    std::unique_lock<std::mutex> ioMutexLock{this->m_ioMutex};
+    if (!this->hasUnreadBytes()) {
+        ioMutexLock.unlock();
+        this->awaitDatagram(socketNumber);
+        ioMutexLock.lock();
+    }
+    if (!this->m_putBackBytes.empty()) {
+        char charToReturn{this->m_putBackBytes.back()};
+        this->m_putBackBytes.pop_back();
+        return charToReturn;
+    }
+    UDPDatagram *frontDatagram{this->frontDatagram()};
+    if ((!frontDatagram) || (frontDatagram->size() == 0)) {
         return 0;
     }
-    char charToReturn{str.at(0)};
-    std::string newDatagramMessage{str.substr(1)};
-    struct sockaddr_in newDatagramAddress;
-    newDatagramAddress.sin_family = this->m_datagramQueue.front().socketAddress().sin_family;
-    newDatagramAddress.sin_port = this->m_datagramQueue.front().socketAddress().sin_port;
-    newDatagramAddress.sin_addr.s_addr = this->m_datagramQueue.front().socketAddress().sin_addr.s_addr;
-    this->m_datagramQueue.pop_front();
-    this->m_datagramQueue.emplace_front(newDatagramAddress, newDatagramMessage);
+    char charToReturn{frontDatagram->data()[this->m_frontReadOffset]};
+    if (this->m_frontReadOffset + 1 == frontDatagram->size()) {
+        this->popDatagram();
+        return charToReturn;
+    }
+    if (this->m_datagramQueue.empty()) {
+        //The cursor only points into the deque, whose front stays put while the rings and shards move on
+        UDPDatagram partialDatagram{std::move(*frontDatagram)};
+        this->popDatagram();
+        this->m_datagramQueue.push_front(std::move(partialDatagram));
+    }
+    this->m_frontReadOffset++;
     return charToReturn;
-
 }
 
 UDPDatagram UDPServer::readDatagram(int socketNumber)
 {
-    this->syncDatagramListener(socketNumber);
+    this->awaitDatagram(socketNumber);
     std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
-    if (this->m_datagramQueue.size() == 0) {
+    this->settleFrontDatagram();
+    UDPDatagram *frontDatagram{this->frontDatagram()};
+    if (!frontDatagram) {
         return UDPDatagram{};
     } else {
-        UDPDatagram returnDatagram{this->m_datagramQueue.front()};
-        this->m_datagramQueue.pop_front();
+        this->m_queuedByteCount -= frontDatagram->size();
+        UDPDatagram returnDatagram{std::move(*frontDatagram)};
+        this->popDatagram();
         return returnDatagram;
     }
 }
 
+ssize_t UDPServer::readDatagramInto(int socketNumber, void *buffer, size_t length)
+{
+    //Without a listener the recvfrom below blocks on its own, so only wait for the listener to queue one
+    if (this->m_isListening) {
+        this->waitForDatagram(socketNumber, std::chrono::milliseconds{this->m_timeout});
+    }
+    {
+        std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
+        this->settleFrontDatagram();
+        UDPDatagram *frontDatagram{this->frontDatagram()};
+        if (frontDatagram) {
+            //Like recv() with MSG_TRUNC, the full size comes back so a short buffer shows up as a return above length
+            ssize_t datagramSize{static_cast<ssize_t>(frontDatagram->size())};
+            memcpy(buffer, frontDatagram->data(), std::min(length, frontDatagram->size()));
+            this->popDatagram();
+            return datagramSize;
+        }
+    }
+    if (this->m_isListening) {
+        return 0;
+    }
+    //Nothing is queued and no listener owns the socket, so the kernel copies straight into the caller's buffer
+    sockaddr_in receivedAddress{};
+    platform_socklen_t socketSize{sizeof(sockaddr_in)};
+#if defined(__linux__)
+    static const constexpr int RECEIVE_FLAGS{MSG_TRUNC};
+#else
+    static const constexpr int RECEIVE_FLAGS{0};
+#endif
+    ssize_t returnValue{recvfrom(socketNumber,
+                        buffer,
+                        length,
+                        RECEIVE_FLAGS,
+                        reinterpret_cast<sockaddr *>(&receivedAddress),
+                        &socketSize)};
+    if (returnValue <= 0) {
+        return 0;
+    }
+    if (this->m_isEchoServer) {
+        this->respondTo(&receivedAddress, static_cast<const char *>(buffer), std::min(length, static_cast<size_t>(returnValue)));
+    }
+    return returnValue;
+}
 
 std::string UDPServer::readLine(int socketNumber)
 {
-    this->syncDatagramListener(socketNumber);
-    std::lock_guard<std::mutex> ioMutexLock{this->m_ioMutex};
-    if (this->m_datagramQueue.size() == 0) {
-        return "";
+    return this->readUntil(socketNumber, this->m_lineEnding);
+}
+
+UDPLineView UDPServer::readLineView(int socketNumber)
+{
+    return this->readUntilView(socketNumber, this->m_lineEnding);
+}
+
+UDPLineView UDPServer::readUntilView(int socketNumber, const std::string &until)
+{
+    std::unique_lock<std::mutex> ioMutexLock{this->m_ioMutex, std::defer_lock};
+    UDPLineView line{};
+    this->awaitLine(socketNumber, until, ioMutexLock, &line);
+    return line;
+}
+
+void UDPServer::awaitLine(int socketNumber, const std::string &until, std::unique_lock<std::mutex> &ioMutexLock, UDPLineView *line)
+{
+    //Leaves ioMutexLock locked, so the caller decides whether the line is copied before anything else can read
+    this->awaitDatagram(socketNumber);
+    ioMutexLock.lock();
+    if ((this->assembleLine(until, line)) || (!this->m_isListening) || (this->queuedDatagramCount() == 0)) {
+        return;
+    }
+    //Only a streaming line can be incomplete, so wait for the datagrams that finish it, up to the timeout
+    std::chrono::steady_clock::time_point deadline{std::chrono::steady_clock::now() + std::chrono::milliseconds{this->m_timeout}};
+    size_t searchedCount{this->queuedDatagramCount()};
+    this->m_datagramWaiterCount.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (this->m_datagramAvailable.wait_until(ioMutexLock, deadline, [this, searchedCount]() {
+        return ((this->queuedDatagramCount() > searchedCount) || (!this->m_isListening));
+    })) {
+        if ((this->assembleLine(until, line)) || (!this->m_isListening)) {
+            break;
+        }
+        searchedCount = this->queuedDatagramCount();
+    }
+    this->m_datagramWaiterCount.fetch_sub(1);
+}
+
+bool UDPServer::assembleLine(const std::string &until, UDPLineView *line)
+{
+    this->m_viewDatagram = UDPDatagram{};
+    this->m_assembledLine.clear();
+    *line = UDPLineView{};
+    if (!this->m_putBackBytes.empty()) {
+        this->settleFrontDatagram();
+    }
+    UDPDatagram *frontDatagram{this->frontDatagram()};
+    if (!frontDatagram) {
+        return false;
+    }
+    const char *unreadData{frontDatagram->data() + this->m_frontReadOffset};
+    size_t unreadLength{frontDatagram->size() - this->m_frontReadOffset};
+    size_t delimiterPosition{findDelimiter(unreadData, unreadLength, until.data(), until.size())};
+    if (delimiterPosition != unreadLength) {
+        *line = this->takeFrontBytes(delimiterPosition + until.size());
+        return true;
+    }
+    if ((!this->m_streamingLines) || (until.empty())) {
+        //A datagram is a line of its own unless lines stream across datagrams
+        *line = this->takeFrontBytes(unreadLength);
+        return true;
+    }
+    return this->assembleStreamingLine(until, line);
+}
+
+UDPLineView UDPServer::takeFrontBytes(size_t count)
+{
+    UDPDatagram *frontDatagram{this->frontDatagram()};
+    UDPLineView line{frontDatagram->data() + this->m_frontReadOffset, count};
+    if (this->m_frontReadOffset + count == frontDatagram->size()) {
+        //The payload is on the heap and moves with the datagram, so the view stays valid
+        this->m_queuedByteCount -= frontDatagram->size();
+        this->m_viewDatagram = std::move(*frontDatagram);
+        this->popDatagram();
+        return line;
+    }
+    if (this->m_datagramQueue.empty()) {
+        this->m_datagramQueue.push_front(std::move(*frontDatagram));
+        this->popRingDatagram();
+    }
+    this->m_frontReadOffset += count;
+    return line;
+}
+
+bool UDPServer::assembleStreamingLine(const std::string &until, UDPLineView *line)
+{
+    //A search that came up short last time resumes after the datagrams it already looked at, as long as the front has not moved
+    if ((this->m_lineSearch.frontGeneration != this->m_frontGeneration) ||
+        (this->m_lineSearch.frontOffset != this->m_frontReadOffset) ||
+        (this->m_lineSearch.delimiter != until)) {
+        this->m_lineSearch = LineSearch{this->m_frontGeneration, this->m_frontReadOffset, until, 0, std::string{}};
+    }
+    size_t datagramIndex{this->m_lineSearch.searchedDatagramCount};
+    while ((datagramIndex < this->m_datagramQueue.size()) || (this->pullRingDatagram())) {
+        const UDPDatagram &datagram = this->m_datagramQueue[datagramIndex];
+        size_t readOffset{datagramIndex == 0 ? this->m_frontReadOffset : 0};
+        const char *data{datagram.data() + readOffset};
+        size_t length{datagram.size() - readOffset};
+        size_t lineEnd{0};
+        //The tail holds the last until.size() - 1 bytes searched, so a delimiter split across datagrams is found too
+        std::string window{this->m_lineSearch.tail};
+        window.append(data, std::min(length, until.size() - 1));
+        size_t windowPosition{findDelimiter(window.data(), window.size(), until.data(), until.size())};
+        if (windowPosition != window.size()) {
+            lineEnd = windowPosition + until.size() - this->m_lineSearch.tail.size();
+        } else {
+            size_t delimiterPosition{findDelimiter(data, length, until.data(), until.size())};
+            if (delimiterPosition != length) {
+                lineEnd = delimiterPosition + until.size();
+            }
+        }
+        if (lineEnd == 0) {
+            window = this->m_lineSearch.tail;
+            window.append(data + length - std::min(length, until.size() - 1), std::min(length, until.size() - 1));
+            this->m_lineSearch.tail = window.substr(window.size() - std::min(window.size(), until.size() - 1));
+            this->m_lineSearch.searchedDatagramCount = ++datagramIndex;
+            continue;
+        }
+        //The line spans datagrams, so it is the one case that gets copied
+        for (size_t i = 0; i < datagramIndex; i++) {
+            const UDPDatagram &spannedDatagram = this->m_datagramQueue[i];
+            size_t spannedOffset{i == 0 ? this->m_frontReadOffset : 0};
+            this->m_assembledLine.append(spannedDatagram.data() + spannedOffset, spannedDatagram.size() - spannedOffset);
+        }
+        this->m_assembledLine.append(data, lineEnd);
+        for (size_t i = 0; i < datagramIndex; i++) {
+            this->popDatagram();
+        }
+        if (lineEnd == length) {
+            this->popDatagram();
+        } else {
+            this->m_frontReadOffset += lineEnd;
+        }
+        *line = UDPLineView{this->m_assembledLine.data(), this->m_assembledLine.size()};
+        return true;
     }
-    std::string stringToReturn{this->m_datagramQueue.front().message()};
-    this->m_datagramQueue.pop_front();
-    return stringToReturn;
+    return false;
 }
 
 UDPServer::~UDPServer()
 {
     this->stopListening();
+    for (auto &it : this->m_receiveShards) {
+        if (it.socketNumber != this->m_socketNumber) {
+            close(it.socketNumber);
+        }
+    }
     shutdown(this->m_socketNumber, SHUT_RDWR);
 }
 
 //Loopback
 const char *UDPClient::DEFAULT_HOST_NAME{"127.0.0.1"};
 const std::string UDPClient::DEFAULT_LINE_ENDING{"\r\n"};
+constexpr size_t UDPClient::SEND_BATCH_SIZE;
+constexpr int UDPClient::SEND_QUEUE_WAIT_TIMEOUT;
+constexpr size_t UDPClient::DEFAULT_ZERO_COPY_THRESHOLD;
+constexpr int UDPClient::ZERO_COPY_DRAIN_TIMEOUT;
+constexpr std::chrono::microseconds UDPClient::DEFAULT_COALESCE_DELAY;
 
 UDPClient::UDPClient() :
     UDPClient(static_cast<std::string>(UDPClient::DEFAULT_HOST_NAME),
@@ -874,15 +2063,66 @@ UDPClient::UDPClient(const std::string &hostName, uint16_t portNumber) :
 }
 
 UDPClient::UDPClient(const std::string &hostName, uint16_t portNumber, uint16_t returnAddressPortNumber) :
+    UDPClient(hostName,
+              portNumber,
+              returnAddressPortNumber,
+              UDPClient::DEFAULT_IO_ENGINE)
+{
+
+}
+
+UDPClient::UDPClient(const std::string &hostName, uint16_t portNumber, uint16_t returnAddressPortNumber, UDPIOEngine ioEngine) :
     m_destinationAddress{},
     m_returnAddress{},
     m_udpSocketIndex{0},
     m_timeout{DEFAULT_TIMEOUT},
-    m_lineEnding{DEFAULT_LINE_ENDING}
+    m_lineEnding{DEFAULT_LINE_ENDING},
+    m_ioEngine{availableIOEngine(ioEngine)},
+#if defined(__linux__)
+    m_ioUring{nullptr},
+#endif
+    m_sendGSO{false},
+    m_gsoSegmentLimit{UDPClient::MAXIMUM_GSO_PAYLOAD},
+    m_connectToDestination{true},
+    m_isConnected{false},
+    m_endpointCache{},
+    m_socketPool{},
+    m_sendQueue{nullptr},
+    m_sendQueuePolicy{DEFAULT_SEND_QUEUE_POLICY},
+    m_isAsyncSending{false},
+    m_sendThread{},
+    m_isSendThreadIdle{false},
+    m_sendProgressWaiterCount{0},
+    m_acceptedSendCount{0},
+    m_completedSendCount{0},
+    m_droppedSendCount{0},
+    m_failedSendCount{0},
+    m_sendPacer{},
+    m_ownsSocket{true},
+    m_zeroCopyTracker{},
+    m_zeroCopyThreshold{DEFAULT_ZERO_COPY_THRESHOLD},
+    m_isCoalescing{false},
+    m_coalescedDatagramSize{0},
+    m_coalesceDelay{DEFAULT_COALESCE_DELAY},
+    m_coalescedLines{},
+    m_coalescedAddress{},
+    m_coalesceDeadline{},
+    m_coalesceThread{},
+    m_stopCoalescing{false}
 {
     this->initialize(hostName,
                      portNumber,
                      returnAddressPortNumber);
+#if defined(__linux__)
+    if (this->m_ioEngine == UDPIOEngine::IoUring) {
+        try {
+            this->m_ioUring.reset(new UDPIoUring{});
+        } catch (std::exception &e) {
+            (void)e;
+            this->m_ioEngine = UDPIOEngine::Socket;
+        }
+    }
+#endif
 
 }
 
@@ -912,31 +2152,683 @@ void UDPClient::setPortNumber(uint16_t portNumber)
                                  + std::to_string(portNumber) 
                                  + ")");
     }
-    this->m_destinationAddress.sin_port = htons(portNumber);
+    this->setDestination(this->m_destinationAddress.sin_addr, portNumber);
 }
 
 void UDPClient::setLineEnding(const std::string &lineEnding)
 {
-    this->m_lineEnding = lineEnding;
+    this->m_lineEnding = lineEnding;
+}
+
+std::string UDPClient::lineEnding() const
+{
+    return this->m_lineEnding;
+}
+
+void UDPClient::setTimeout(unsigned long int timeout)
+{
+    this->m_timeout = timeout;
+}
+
+void UDPClient::setHostName(const std::string &hostName)
+{
+    this->setDestination(this->resolveHostName(hostName), this->portNumber());
+}
+
+in_addr UDPClient::resolveHostName(const std::string &hostName)
+{
+    //Dotted quads parse in place, and names go through the endpoint cache so repeat sends skip the lookup
+    in_addr address{};
+    if (inet_pton(AF_INET, hostName.c_str(), &address) == 1) {
+        return address;
+    }
+    if (!this->m_endpointCache.resolveNow(hostName, &address)) {
+       throw std::runtime_error("ERROR: UDPClient could not resolve adress " + tQuoted(hostName));
+    }
+    return address;
+}
+
+bool UDPClient::lookupHostName(const std::string &hostName, in_addr *address)
+{
+    //Sends never wait on DNS, a name the cache has not resolved yet is looked up in the background and this send fails
+    if (inet_pton(AF_INET, hostName.c_str(), address) == 1) {
+        return true;
+    }
+    if (!this->m_endpointCache.resolve(hostName, address)) {
+        errno = EAGAIN;
+        return false;
+    }
+    return true;
+}
+
+void UDPClient::setDestination(in_addr address, uint16_t portNumber)
+{
+    //The coalescing thread sends to the destination, so it only changes under the coalesce lock, once pending lines are out
+    std::lock_guard<std::mutex> coalesceLock{this->m_coalesceMutex};
+    if ((this->m_destinationAddress.sin_addr.s_addr == address.s_addr) && (this->m_destinationAddress.sin_port == htons(portNumber))) {
+        return;
+    }
+    this->sendCoalescedLines();
+    this->m_destinationAddress.sin_addr = address;
+    this->m_destinationAddress.sin_port = htons(portNumber);
+    this->updateConnection();
+}
+
+void UDPClient::connectDestination()
+{
+    std::lock_guard<std::mutex> coalesceLock{this->m_coalesceMutex};
+    this->sendCoalescedLines();
+    this->updateConnection();
+}
+
+void UDPClient::updateConnection()
+{
+    //A connected socket lets send() skip the per-packet route lookup, but it also only receives from that peer
+    this->m_isConnected = false;
+    if (this->m_connectToDestination) {
+        this->m_isConnected = (connect(this->m_udpSocketIndex, reinterpret_cast<sockaddr *>(&this->m_destinationAddress), sizeof(this->m_destinationAddress)) == 0);
+    } else {
+        sockaddr unspecifiedAddress{};
+        unspecifiedAddress.sa_family = AF_UNSPEC;
+        connect(this->m_udpSocketIndex, &unspecifiedAddress, sizeof(unspecifiedAddress));
+    }
+}
+
+sockaddr_in *UDPClient::sendAddress()
+{
+    return (this->m_isConnected ? nullptr : &this->m_destinationAddress);
+}
+
+void UDPClient::setConnectToDestination(bool connectToDestination)
+{
+    this->m_connectToDestination = connectToDestination;
+    this->connectDestination();
+}
+
+void UDPClient::shareSocket(int socketNumber)
+{
+    //Replies to a bound socket may come from any peer, so it is never connected to one destination
+    this->setConnectToDestination(false);
+    std::lock_guard<std::mutex> coalesceLock{this->m_coalesceMutex};
+    this->sendCoalescedLines();
+    //The old socket's zero-copy notifications are lost once it closes, so they are reaped first
+    this->m_zeroCopyTracker.disable(std::chrono::milliseconds{UDPClient::ZERO_COPY_DRAIN_TIMEOUT});
+    if (this->m_ownsSocket) {
+        close(this->m_udpSocketIndex);
+    }
+    this->m_udpSocketIndex = socketNumber;
+    this->m_ownsSocket = false;
+    this->m_socketPool.clear();
+}
+
+bool UDPClient::connectsToDestination() const
+{
+    return this->m_connectToDestination;
+}
+
+bool UDPClient::isConnected() const
+{
+    return this->m_isConnected;
+}
+
+void UDPClient::prefetchEndpoint(const std::string &hostName)
+{
+    in_addr address{};
+    if (inet_pton(AF_INET, hostName.c_str(), &address) != 1) {
+        this->m_endpointCache.prefetch(hostName);
+    }
+}
+
+void UDPClient::setEndpointTimeToLive(std::chrono::seconds timeToLive)
+{
+    this->m_endpointCache.setTimeToLive(timeToLive);
+}
+
+std::chrono::seconds UDPClient::endpointTimeToLive() const
+{
+    return this->m_endpointCache.timeToLive();
+}
+
+void UDPClient::setSocketPoolSize(size_t socketPoolSize)
+{
+    this->m_socketPool.setCapacity(socketPoolSize);
+}
+
+size_t UDPClient::socketPoolSize() const
+{
+    return this->m_socketPool.capacity();
+}
+
+void UDPClient::startAsyncSend(size_t sendQueueCapacity)
+{
+    if (this->m_isAsyncSending.load()) {
+        return;
+    }
+    this->m_sendQueue.reset(new MPMCRingBuffer<QueuedSend>{sendQueueCapacity});
+#if defined(__linux__)
+    this->m_queuedMessageHeaders.resize(UDPClient::SEND_BATCH_SIZE);
+    this->m_queuedIoVectors.resize(UDPClient::SEND_BATCH_SIZE);
+#endif
+    this->m_isAsyncSending.store(true);
+    this->m_sendThread = std::thread{&UDPClient::asyncSendLoop, this};
+}
+
+void UDPClient::stopAsyncSend()
+{
+    if (!this->m_isAsyncSending.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> sendQueueLock{this->m_sendQueueMutex};
+    }
+    this->m_sendQueued.notify_all();
+    this->m_sendProgress.notify_all();
+    if (this->m_sendThread.joinable()) {
+        this->m_sendThread.join();
+    }
+    //Anything pushed while the send thread was on its way out still goes out, from this thread
+    std::vector<QueuedSend> sendBatch{};
+    QueuedSend queuedSend{};
+    while (this->m_sendQueue->tryPop(queuedSend)) {
+        sendBatch.push_back(std::move(queuedSend));
+    }
+    this->sendQueuedBatch(sendBatch);
+    this->m_completedSendCount.fetch_add(sendBatch.size());
+    this->notifySendProgress();
+}
+
+bool UDPClient::isAsyncSend() const
+{
+    return this->m_isAsyncSending.load();
+}
+
+bool UDPClient::flushSendQueue(std::chrono::nanoseconds timeout)
+{
+    if (this->m_isCoalescing.load(std::memory_order_relaxed)) {
+        this->flushCoalescedLines();
+    }
+    this->m_sendProgressWaiterCount.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::unique_lock<std::mutex> sendQueueLock{this->m_sendQueueMutex};
+    bool isFlushed{this->m_sendProgress.wait_for(sendQueueLock, timeout, [this]() {
+        uint64_t acceptedSendCount{this->m_acceptedSendCount.load()};
+        return (this->m_completedSendCount.load() >= acceptedSendCount);
+    })};
+    this->m_sendProgressWaiterCount.fetch_sub(1);
+    return isFlushed;
+}
+
+void UDPClient::setSendQueuePolicy(SendQueuePolicy sendQueuePolicy)
+{
+    this->m_sendQueuePolicy.store(sendQueuePolicy);
+    //Writers blocked on a full queue re-check the policy they are waiting under
+    this->notifySendProgress();
+}
+
+SendQueuePolicy UDPClient::sendQueuePolicy() const
+{
+    return this->m_sendQueuePolicy.load();
+}
+
+size_t UDPClient::queuedSendCount() const
+{
+    return (this->m_sendQueue ? this->m_sendQueue->size() : 0);
+}
+
+uint64_t UDPClient::droppedSendCount() const
+{
+    return this->m_droppedSendCount.load();
+}
+
+uint64_t UDPClient::failedSendCount() const
+{
+    return this->m_failedSendCount.load();
+}
+
+void UDPClient::setSendRate(double packetsPerSecond, double bytesPerSecond)
+{
+    this->m_sendPacer.setRate(packetsPerSecond, bytesPerSecond);
+#if defined(SO_MAX_PACING_RATE)
+    //With the fq qdisc on the way out the kernel also spreads each admitted burst, and without it the option is ignored
+    unsigned int pacingRate{std::numeric_limits<unsigned int>::max()};
+    if (bytesPerSecond > 0.0) {
+        pacingRate = static_cast<unsigned int>(std::min<double>(bytesPerSecond, std::numeric_limits<unsigned int>::max() - 1));
+    }
+    setsockopt(this->m_udpSocketIndex, SOL_SOCKET, SO_MAX_PACING_RATE, &pacingRate, sizeof(pacingRate));
+    this->m_socketPool.setSocketOption(SOL_SOCKET, SO_MAX_PACING_RATE, pacingRate);
+#endif
+}
+
+double UDPClient::sendPacketRate() const
+{
+    return this->m_sendPacer.packetsPerSecond();
+}
+
+double UDPClient::sendByteRate() const
+{
+    return this->m_sendPacer.bytesPerSecond();
+}
+
+ssize_t UDPClient::writeZeroCopy(const void *data, size_t length, ZeroCopyCompletion completion)
+{
+    return this->sendZeroCopy(this->m_destinationAddress, data, length, std::move(completion));
+}
+
+ssize_t UDPClient::writeZeroCopy(const std::string &hostName, uint16_t portNumber, const void *data, size_t length, ZeroCopyCompletion completion)
+{
+    if (!this->isValidPortNumber(portNumber)) {
+        //setPortNumber() owns the invalid port error
+        this->setPortNumber(portNumber);
+    }
+    sockaddr_in destinationAddress{};
+    destinationAddress.sin_family = AF_INET;
+    destinationAddress.sin_port = htons(portNumber);
+    if (!this->lookupHostName(hostName, &destinationAddress.sin_addr)) {
+        return -1;
+    }
+    return this->sendZeroCopy(destinationAddress, data, length, std::move(completion));
+}
+
+void UDPClient::setZeroCopyThreshold(size_t zeroCopyThreshold)
+{
+    this->m_zeroCopyThreshold = zeroCopyThreshold;
+}
+
+size_t UDPClient::zeroCopyThreshold() const
+{
+    return this->m_zeroCopyThreshold;
+}
+
+size_t UDPClient::reapZeroCopyCompletions()
+{
+    return this->m_zeroCopyTracker.reapCompletions();
+}
+
+bool UDPClient::waitForZeroCopyCompletions(std::chrono::nanoseconds timeout)
+{
+    return this->m_zeroCopyTracker.waitForCompletions(timeout);
+}
+
+size_t UDPClient::pendingZeroCopyCount() const
+{
+    return this->m_zeroCopyTracker.pendingCount();
+}
+
+uint64_t UDPClient::copiedZeroCopyCount() const
+{
+    return this->m_zeroCopyTracker.copiedCount();
+}
+
+void UDPClient::setLineCoalescing(size_t coalescedDatagramSize, std::chrono::microseconds coalesceDelay)
+{
+    if (coalescedDatagramSize > UDPClient::MAXIMUM_GSO_PAYLOAD) {
+        throw std::runtime_error("In UDPClient::setLineCoalescing(size_t, std::chrono::microseconds): Invalid coalesced datagram size, must be at most " +
+                                 std::to_string(UDPClient::MAXIMUM_GSO_PAYLOAD)
+                                 + " ("
+                                 + std::to_string(coalescedDatagramSize)
+                                 + ")");
+    }
+    {
+        std::lock_guard<std::mutex> coalesceLock{this->m_coalesceMutex};
+        this->sendCoalescedLines();
+        this->m_coalescedDatagramSize = coalescedDatagramSize;
+        this->m_coalesceDelay = coalesceDelay;
+        this->m_stopCoalescing = (coalescedDatagramSize == 0);
+        this->m_isCoalescing.store(coalescedDatagramSize != 0);
+    }
+    this->m_coalesceCondition.notify_all();
+    if (coalescedDatagramSize == 0) {
+        if (this->m_coalesceThread.joinable()) {
+            this->m_coalesceThread.join();
+        }
+    } else if (!this->m_coalesceThread.joinable()) {
+        this->m_coalesceThread = std::thread{&UDPClient::coalesceLoop, this};
+    }
+}
+
+size_t UDPClient::lineCoalescingSize() const
+{
+    return this->m_coalescedDatagramSize;
+}
+
+std::chrono::microseconds UDPClient::lineCoalescingDelay() const
+{
+    return this->m_coalesceDelay;
+}
+
+void UDPClient::flushCoalescedLines()
+{
+    std::lock_guard<std::mutex> coalesceLock{this->m_coalesceMutex};
+    this->sendCoalescedLines();
+}
+
+ssize_t UDPClient::coalesceLine(const sockaddr_in &destinationAddress, const char *data, size_t length)
+{
+    size_t lineLength{length + (endsWith(data, length, this->m_lineEnding) ? 0 : this->m_lineEnding.size())};
+    bool isFirstLine{false};
+    {
+        std::lock_guard<std::mutex> coalesceLock{this->m_coalesceMutex};
+        if (!this->m_coalescedLines.empty()) {
+            bool isSameDestination{(destinationAddress.sin_addr.s_addr == this->m_coalescedAddress.sin_addr.s_addr) && (destinationAddress.sin_port == this->m_coalescedAddress.sin_port)};
+            if ((!isSameDestination) || (this->m_coalescedLines.size() + lineLength > this->m_coalescedDatagramSize)) {
+                this->sendCoalescedLines();
+            }
+        }
+        if (lineLength > this->m_coalescedDatagramSize) {
+            return -1;
+        }
+        if (this->m_coalescedLines.empty()) {
+            this->m_coalescedAddress = destinationAddress;
+            this->m_coalesceDeadline = std::chrono::steady_clock::now() + this->m_coalesceDelay;
+            isFirstLine = true;
+        }
+        this->m_coalescedLines.append(data, length);
+        this->m_coalescedLines.append(this->m_lineEnding.data(), lineLength - length);
+        if (this->m_coalescedLines.size() == this->m_coalescedDatagramSize) {
+            this->sendCoalescedLines();
+        }
+    }
+    if (isFirstLine) {
+        this->m_coalesceCondition.notify_one();
+    }
+    return static_cast<ssize_t>(lineLength);
+}
+
+void UDPClient::sendCoalescedLines()
+{
+    if (this->m_coalescedLines.empty()) {
+        return;
+    }
+    if (this->m_isAsyncSending.load(std::memory_order_relaxed)) {
+        this->enqueueSend(this->m_coalescedAddress, this->m_coalescedLines.data(), this->m_coalescedLines.size(), false);
+    } else {
+        //Always the client socket, because the flush thread must not share the socket pool or the io_uring ring with the caller
+        bool isDefaultDestination{(this->m_coalescedAddress.sin_addr.s_addr == this->m_destinationAddress.sin_addr.s_addr) && (this->m_coalescedAddress.sin_port == this->m_destinationAddress.sin_port)};
+        iovec ioVector{const_cast<char *>(this->m_coalescedLines.data()), this->m_coalescedLines.size()};
+        msghdr messageHeader{};
+        messageHeader.msg_name = (isDefaultDestination ? this->sendAddress() : &this->m_coalescedAddress);
+        messageHeader.msg_namelen = (messageHeader.msg_name ? sizeof(sockaddr_in) : 0);
+        messageHeader.msg_iov = &ioVector;
+        messageHeader.msg_iovlen = 1;
+        if (this->m_sendPacer.isEnabled()) {
+            size_t length{ioVector.iov_len};
+            this->m_sendPacer.acquire(1, [length](size_t) { return length; });
+        }
+        this->sendMessage(this->m_udpSocketIndex, &messageHeader);
+    }
+    this->m_coalescedLines.clear();
+}
+
+void UDPClient::coalesceLoop()
+{
+    std::unique_lock<std::mutex> coalesceLock{this->m_coalesceMutex};
+    while (!this->m_stopCoalescing) {
+        if (this->m_coalescedLines.empty()) {
+            this->m_coalesceCondition.wait(coalesceLock);
+        } else if (std::chrono::steady_clock::now() >= this->m_coalesceDeadline) {
+            this->sendCoalescedLines();
+        } else {
+            this->m_coalesceCondition.wait_until(coalesceLock, this->m_coalesceDeadline);
+        }
+    }
+}
+
+ssize_t UDPClient::sendZeroCopy(const sockaddr_in &destinationAddress, const void *data, size_t length, ZeroCopyCompletion &&completion)
+{
+    if (this->m_isCoalescing.load(std::memory_order_relaxed)) {
+        this->flushCoalescedLines();
+    }
+    //Pinning pages and reaping a notification costs more than copying a small payload, and queued sends are copied anyway
+    bool isDefaultDestination{(destinationAddress.sin_addr.s_addr == this->m_destinationAddress.sin_addr.s_addr) && (destinationAddress.sin_port == this->m_destinationAddress.sin_port)};
+    if ((length < this->m_zeroCopyThreshold) || (this->m_isAsyncSending.load(std::memory_order_relaxed)) || (!this->m_zeroCopyTracker.enable(this->m_udpSocketIndex))) {
+        ssize_t bytesWritten{0};
+        if (this->m_isAsyncSending.load(std::memory_order_relaxed)) {
+            bytesWritten = this->enqueueSend(destinationAddress, static_cast<const char *>(data), length, false);
+        } else {
+            iovec ioVector{const_cast<void *>(data), length};
+            bytesWritten = this->sendDatagram(destinationAddress, &ioVector, 1);
+        }
+        if (completion) {
+            completion(data, length, true);
+        }
+        return bytesWritten;
+    }
+    this->m_zeroCopyTracker.reapCompletions();
+    //Zero-copy sends always leave through the client socket, because a pooled socket could be evicted with pages still pinned
+    iovec ioVector{const_cast<void *>(data), length};
+    msghdr messageHeader{};
+    messageHeader.msg_name = (isDefaultDestination ? this->sendAddress() : const_cast<sockaddr_in *>(&destinationAddress));
+    messageHeader.msg_namelen = (messageHeader.msg_name ? sizeof(sockaddr_in) : 0);
+    messageHeader.msg_iov = &ioVector;
+    messageHeader.msg_iovlen = 1;
+    if (this->m_sendPacer.isEnabled()) {
+        this->m_sendPacer.acquire(1, [length](size_t) { return length; });
+    }
+    unsigned int retryCount{0};
+    do {
+        ssize_t bytesWritten{this->m_zeroCopyTracker.send(&messageHeader, data, length, std::move(completion))};
+        if (bytesWritten != -1) {
+            return bytesWritten;
+        } else if (errno == ENOBUFS) {
+            //Too many unreaped notifications are charged against the socket option memory
+            this->m_zeroCopyTracker.reapCompletions();
+        } else if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != ECONNREFUSED)) {
+            break;
+        }
+    } while (retryCount++ < UDPClient::SEND_RETRY_COUNT);
+    //The kernel never took the pages, so the payload is copied instead and released right away
+    ssize_t bytesWritten{this->sendMessage(this->m_udpSocketIndex, &messageHeader)};
+    if (completion) {
+        completion(data, length, true);
+    }
+    return bytesWritten;
+}
+
+ssize_t UDPClient::enqueueSend(const sockaddr_in &destinationAddress, const char *data, size_t length, bool appendLineEnding)
+{
+    QueuedSend queuedSend{};
+    queuedSend.payload.reserve(length + this->m_lineEnding.size());
+    queuedSend.payload.append(data, length);
+    if ((appendLineEnding) && (!endsWith(data, length, this->m_lineEnding))) {
+        queuedSend.payload += this->m_lineEnding;
+    }
+    queuedSend.destinationAddress = destinationAddress;
+    ssize_t queuedLength{static_cast<ssize_t>(queuedSend.payload.size())};
+    //Counted before the push, so a flush can never see the send thread finish a message it has not accounted for
+    this->m_acceptedSendCount.fetch_add(1);
+    if (!this->pushQueuedSend(std::move(queuedSend))) {
+        this->m_droppedSendCount.fetch_add(1);
+        this->m_completedSendCount.fetch_add(1);
+        return 0;
+    }
+    this->notifySendThread();
+    return queuedLength;
+}
+
+bool UDPClient::pushQueuedSend(QueuedSend &&queuedSend)
+{
+    if (this->m_sendQueue->tryPush(std::move(queuedSend))) {
+        return true;
+    }
+    SendQueuePolicy sendQueuePolicy{this->m_sendQueuePolicy.load()};
+    if (sendQueuePolicy == SendQueuePolicy::DropNewest) {
+        return false;
+    } else if (sendQueuePolicy == SendQueuePolicy::DropOldest) {
+        QueuedSend oldestSend{};
+        while (!this->m_sendQueue->tryPush(std::move(queuedSend))) {
+            if (this->m_sendQueue->tryPop(oldestSend)) {
+                this->m_droppedSendCount.fetch_add(1);
+                this->m_completedSendCount.fetch_add(1);
+            }
+        }
+        return true;
+    }
+    this->m_sendProgressWaiterCount.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::unique_lock<std::mutex> sendQueueLock{this->m_sendQueueMutex};
+    bool isPushed{false};
+    this->m_sendProgress.wait(sendQueueLock, [this, &queuedSend, &isPushed]() {
+        isPushed = this->m_sendQueue->tryPush(std::move(queuedSend));
+        return ((isPushed) || (!this->m_isAsyncSending.load()) || (this->m_sendQueuePolicy.load() != SendQueuePolicy::Block));
+    });
+    this->m_sendProgressWaiterCount.fetch_sub(1);
+    sendQueueLock.unlock();
+    if ((!isPushed) && (this->m_isAsyncSending.load())) {
+        return this->pushQueuedSend(std::move(queuedSend));
+    }
+    return isPushed;
+}
+
+void UDPClient::notifySendThread()
+{
+    //Pairs with the fence in asyncSendLoop(), so either the send thread sees the message or this sees it idle
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!this->m_isSendThreadIdle.load(std::memory_order_relaxed)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> sendQueueLock{this->m_sendQueueMutex};
+    }
+    this->m_sendQueued.notify_one();
+}
+
+void UDPClient::notifySendProgress()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (this->m_sendProgressWaiterCount.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> sendQueueLock{this->m_sendQueueMutex};
+    }
+    this->m_sendProgress.notify_all();
+}
+
+void UDPClient::asyncSendLoop()
+{
+    std::vector<QueuedSend> sendBatch{};
+    sendBatch.reserve(UDPClient::SEND_BATCH_SIZE);
+    QueuedSend queuedSend{};
+    while (true) {
+        while ((sendBatch.size() < UDPClient::SEND_BATCH_SIZE) && (this->m_sendQueue->tryPop(queuedSend))) {
+            sendBatch.push_back(std::move(queuedSend));
+        }
+        if (!sendBatch.empty()) {
+            //Writers blocked on a full queue can refill it while this batch is on its way out
+            this->notifySendProgress();
+            this->sendQueuedBatch(sendBatch);
+            this->m_completedSendCount.fetch_add(sendBatch.size());
+            sendBatch.clear();
+            this->notifySendProgress();
+            continue;
+        }
+        if (!this->m_isAsyncSending.load()) {
+            return;
+        }
+        this->m_isSendThreadIdle.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> sendQueueLock{this->m_sendQueueMutex};
+            this->m_sendQueued.wait_for(sendQueueLock, std::chrono::milliseconds{UDPClient::SEND_QUEUE_WAIT_TIMEOUT}, [this]() {
+                return ((!this->m_sendQueue->empty()) || (!this->m_isAsyncSending.load()));
+            });
+        }
+        this->m_isSendThreadIdle.store(false);
+    }
 }
 
-std::string UDPClient::lineEnding() const
+void UDPClient::sendQueuedBatch(std::vector<QueuedSend> &sendBatch)
 {
-    return this->m_lineEnding;
+    size_t runStart{0};
+    while (runStart < sendBatch.size()) {
+        //Consecutive messages for one endpoint go out together, on the pooled socket connected to it when there is one
+        const sockaddr_in &destinationAddress = sendBatch[runStart].destinationAddress;
+        size_t runEnd{runStart + 1};
+        while ((runEnd < sendBatch.size()) &&
+               (sendBatch[runEnd].destinationAddress.sin_addr.s_addr == destinationAddress.sin_addr.s_addr) &&
+               (sendBatch[runEnd].destinationAddress.sin_port == destinationAddress.sin_port)) {
+            runEnd++;
+        }
+        int socketNumber{this->m_connectToDestination ? this->m_socketPool.connectedSocket(destinationAddress) : -1};
+        if (socketNumber != -1) {
+            this->sendQueuedRun(socketNumber, nullptr, &sendBatch[runStart], runEnd - runStart);
+        } else {
+            this->sendQueuedRun(this->m_udpSocketIndex, &destinationAddress, &sendBatch[runStart], runEnd - runStart);
+        }
+        runStart = runEnd;
+    }
 }
 
-void UDPClient::setTimeout(unsigned long int timeout)
+void UDPClient::sendQueuedRun(int socketNumber, const sockaddr_in *destinationAddress, QueuedSend *queuedSends, size_t count)
 {
-    this->m_timeout = timeout;
+#if defined(__linux__)
+    for (size_t i = 0; i < count; i++) {
+        this->m_queuedIoVectors[i].iov_base = const_cast<char *>(queuedSends[i].payload.data());
+        this->m_queuedIoVectors[i].iov_len = queuedSends[i].payload.size();
+        this->m_queuedMessageHeaders[i].msg_hdr = msghdr{};
+        this->m_queuedMessageHeaders[i].msg_hdr.msg_name = const_cast<sockaddr_in *>(destinationAddress);
+        this->m_queuedMessageHeaders[i].msg_hdr.msg_namelen = (destinationAddress ? sizeof(sockaddr_in) : 0);
+        this->m_queuedMessageHeaders[i].msg_hdr.msg_iov = &this->m_queuedIoVectors[i];
+        this->m_queuedMessageHeaders[i].msg_hdr.msg_iovlen = 1;
+    }
+    size_t sentCount{0};
+    size_t pacedCount{0};
+    unsigned int timeoutCount{0};
+    while (sentCount < count) {
+        if (sentCount == pacedCount) {
+            pacedCount += this->pacedMessageCount(&this->m_queuedMessageHeaders[sentCount], count - sentCount);
+        }
+        int returnValue{sendmmsg(socketNumber, &this->m_queuedMessageHeaders[sentCount], pacedCount - sentCount, MSG_DONTWAIT)};
+        if (returnValue > 0) {
+            sentCount += returnValue;
+            timeoutCount = 0;
+        } else if (!this->retryQueuedSend(socketNumber, timeoutCount)) {
+            //sendmmsg stops at the first failing message, so count that one and carry on after it
+            this->m_failedSendCount.fetch_add(1);
+            sentCount++;
+            timeoutCount = 0;
+        }
+    }
+#else
+    for (size_t i = 0; i < count; i++) {
+        iovec ioVector{const_cast<char *>(queuedSends[i].payload.data()), queuedSends[i].payload.size()};
+        msghdr messageHeader{};
+        messageHeader.msg_name = const_cast<sockaddr_in *>(destinationAddress);
+        messageHeader.msg_namelen = (destinationAddress ? sizeof(sockaddr_in) : 0);
+        messageHeader.msg_iov = &ioVector;
+        messageHeader.msg_iovlen = 1;
+        if (this->m_sendPacer.isEnabled()) {
+            this->m_sendPacer.acquire(1, [&ioVector](size_t) { return ioVector.iov_len; });
+        }
+        unsigned int timeoutCount{0};
+        while (sendmsg(socketNumber, &messageHeader, MSG_DONTWAIT) == -1) {
+            if (!this->retryQueuedSend(socketNumber, timeoutCount)) {
+                this->m_failedSendCount.fetch_add(1);
+                break;
+            }
+        }
+    }
+#endif
 }
 
-void UDPClient::setHostName(const std::string &hostName)
+bool UDPClient::retryQueuedSend(int socketNumber, unsigned int &timeoutCount)
 {
-    sockaddr_storage temp{};
-    if (resolveAddressHelper (hostName, AF_INET, std::to_string(this->portNumber()), &temp) != 0) {
-       throw std::runtime_error("ERROR: UDPClient could not resolve adress " + tQuoted(hostName));
+    if ((errno == EINTR) || (errno == ECONNREFUSED)) {
+        //Interrupted, or an earlier ICMP error being reported, and either way this message was not sent yet
+        return true;
     }
-    inet_pton(AF_INET, hostName.c_str(), &(this->m_destinationAddress.sin_addr));
+    if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != ENOBUFS)) {
+        return false;
+    }
+    //A full socket buffer is backpressure, so sleep until the kernel has room instead of dropping or spinning
+    pollfd pollDescriptor{};
+    pollDescriptor.fd = socketNumber;
+    pollDescriptor.events = POLLOUT;
+    if (poll(&pollDescriptor, 1, UDPClient::SEND_QUEUE_WAIT_TIMEOUT) > 0) {
+        return true;
+    }
+    //A buffer that stays full across every wait will not drain, so the message fails and the queue moves on
+    return ((this->m_isAsyncSending.load()) && (timeoutCount++ < UDPClient::SEND_RETRY_COUNT));
 }
 
 void UDPClient::openPort()
@@ -1002,12 +2894,8 @@ void UDPClient::initialize(const std::string &hostName, uint16_t portNumber, uin
     //This cannot be set with UDP sockets:
     //inet_pton(AF_INET, returnAddressHostName.c_str(), &(this->m_returnAddress.sin_addr));
     
-    std::unique_ptr<sockaddr_storage> temp{std::unique_ptr<sockaddr_storage>{new sockaddr_storage{}}};
-    if (resolveAddressHelper (hostName, AF_INET, std::to_string(this->portNumber()), temp.get()) != 0) {
-       throw std::runtime_error("ERROR: UDPClient could not resolve adress " + tQuoted(hostName));
-    } else {
-        inet_pton(AF_INET, inet_ntoa(reinterpret_cast<sockaddr_in *>(temp.get())->sin_addr), &(this->m_destinationAddress.sin_addr));
-    }
+    this->m_destinationAddress.sin_addr = this->resolveHostName(hostName);
+    this->connectDestination();
 
     /*
     if (bind(this->m_udpSocketIndex, reinterpret_cast<sockaddr*>(&this->m_returnAddress), sizeof(this->m_returnAddress)) != 0) {
@@ -1035,54 +2923,407 @@ int UDPClient::resolveAddressHelper(const std::string &hostName, int family, con
 
 ssize_t UDPClient::writeByte(char toSend) 
 { 
-    return this->writeLine(this->hostName(), this->portNumber(), std::string{1, toSend}); 
+    return this->sendLine(this->m_destinationAddress, &toSend, 1); 
 }
 
 ssize_t UDPClient::writeByte(const std::string &hostName, uint16_t portNumber, char toSend) 
 { 
-    return this->writeLine(hostName, portNumber, std::string{1, toSend}); 
+    return this->writeLine(hostName, portNumber, &toSend, 1); 
 }
 
 ssize_t UDPClient::writeLine(const char *str) 
 { 
-    return this->writeLine(this->hostName(), this->portNumber(), std::string{str}); 
+    return this->sendLine(this->m_destinationAddress, str, strlen(str)); 
 }
 
 ssize_t UDPClient::writeLine(const std::string &hostName, uint16_t portNumber, const char *str) 
 { 
-    return this->writeLine(hostName, portNumber, std::string{str}); 
+    return this->writeLine(hostName, portNumber, str, strlen(str)); 
 }
 
 ssize_t UDPClient::writeLine(const std::string &hostName, uint16_t portNumber, const std::string &str)
 {
-    if (this->hostName() != hostName) {
-        this->setHostName(hostName);   
-    }
-    if (this->portNumber() != portNumber) {
+    return this->writeLine(hostName, portNumber, str.data(), str.size());
+}
+
+ssize_t UDPClient::writeLine(const std::string &hostName, uint16_t portNumber, const char *data, size_t length)
+{
+    if (!this->isValidPortNumber(portNumber)) {
+        //setPortNumber() owns the invalid port error
         this->setPortNumber(portNumber);
     }
-    std::string copyString{str};
-    if (!endsWith(copyString, this->m_lineEnding)) {
-        copyString += this->m_lineEnding;
+    sockaddr_in destinationAddress{};
+    destinationAddress.sin_family = AF_INET;
+    destinationAddress.sin_port = htons(portNumber);
+    if (!this->lookupHostName(hostName, &destinationAddress.sin_addr)) {
+        return -1;
+    }
+    return this->sendLine(destinationAddress, data, length);
+}
+
+ssize_t UDPClient::writeLine(const std::string &str)
+{
+    return this->sendLine(this->m_destinationAddress, str.data(), str.size());
+}
+
+ssize_t UDPClient::sendLine(const sockaddr_in &destinationAddress, const char *data, size_t length)
+{
+    if (this->m_isCoalescing.load(std::memory_order_relaxed)) {
+        ssize_t coalescedLength{this->coalesceLine(destinationAddress, data, length)};
+        if (coalescedLength != -1) {
+            return coalescedLength;
+        }
+        //Too long to share a datagram, so it goes out on its own right after the lines before it
+    }
+    if (this->m_isAsyncSending.load(std::memory_order_relaxed)) {
+        return this->enqueueSend(destinationAddress, data, length, true);
+    }
+    //The line ending goes out as a second iovec, so the payload is never copied to append it
+    iovec ioVectors[2]{ {const_cast<char *>(data), length},
+                        {const_cast<char *>(this->m_lineEnding.data()), this->m_lineEnding.size()} };
+    return this->sendDatagram(destinationAddress, ioVectors, (endsWith(data, length, this->m_lineEnding) ? 1 : 2));
+}
+
+ssize_t UDPClient::write(const void *data, size_t length)
+{
+    if (this->m_isCoalescing.load(std::memory_order_relaxed)) {
+        this->flushCoalescedLines();
+    }
+    if (this->m_isAsyncSending.load(std::memory_order_relaxed)) {
+        return this->enqueueSend(this->m_destinationAddress, static_cast<const char *>(data), length, false);
+    }
+    return this->sendDatagram(data, length);
+}
+
+UDPIOEngine UDPClient::ioEngine() const
+{
+    return this->m_ioEngine;
+}
+
+ssize_t UDPClient::sendDatagram(const void *data, size_t length)
+{
+    iovec ioVector{const_cast<void *>(data), length};
+    return this->sendDatagram(this->m_udpSocketIndex, this->sendAddress(), &ioVector, 1);
+}
+
+ssize_t UDPClient::sendDatagram(const sockaddr_in &destinationAddress, iovec *ioVectors, size_t ioVectorCount)
+{
+    if ((destinationAddress.sin_addr.s_addr == this->m_destinationAddress.sin_addr.s_addr) && (destinationAddress.sin_port == this->m_destinationAddress.sin_port)) {
+        return this->sendDatagram(this->m_udpSocketIndex, this->sendAddress(), ioVectors, ioVectorCount);
+    }
+    //Other destinations get their own connected socket, unless replies have to come back on the client socket
+    if (this->m_connectToDestination) {
+        int socketNumber{this->m_socketPool.connectedSocket(destinationAddress)};
+        if (socketNumber != -1) {
+            return this->sendDatagram(socketNumber, nullptr, ioVectors, ioVectorCount);
+        }
+    }
+    return this->sendDatagram(this->m_udpSocketIndex, &destinationAddress, ioVectors, ioVectorCount);
+}
+
+ssize_t UDPClient::sendDatagram(int socketNumber, const sockaddr_in *destinationAddress, iovec *ioVectors, size_t ioVectorCount)
+{
+    msghdr messageHeader{};
+    messageHeader.msg_name = const_cast<sockaddr_in *>(destinationAddress);
+    messageHeader.msg_namelen = (destinationAddress ? sizeof(sockaddr_in) : 0);
+    messageHeader.msg_iov = ioVectors;
+    messageHeader.msg_iovlen = ioVectorCount;
+    if (this->m_sendPacer.isEnabled()) {
+        size_t length{messageLength(messageHeader)};
+        this->m_sendPacer.acquire(1, [length](size_t) { return length; });
+    }
+#if defined(__linux__)
+    if (this->m_ioUring) {
+        mmsghdr ringMessageHeader{};
+        ringMessageHeader.msg_hdr = messageHeader;
+        ssize_t bytesWritten{0};
+        this->m_ioUring->sendMessages(socketNumber, &ringMessageHeader, 1, &bytesWritten);
+        return (bytesWritten > 0 ? bytesWritten : 0);
     }
+#endif
+    return this->sendMessage(socketNumber, &messageHeader);
+}
+
+ssize_t UDPClient::sendMessage(int socketNumber, const msghdr *messageHeader)
+{
     unsigned int retryCount{0};
     do {
-        ssize_t bytesWritten{sendto(this->m_udpSocketIndex, 
-                            copyString.c_str(), 
-                            strlen(copyString.c_str()),
-                            MSG_DONTWAIT,
-                            reinterpret_cast<sockaddr*>(&this->m_destinationAddress),
-                            sizeof(this->m_destinationAddress)) };
-        if ((bytesWritten != -1) && (errno != EAGAIN) && (errno != EWOULDBLOCK))  {
+        ssize_t bytesWritten{sendmsg(socketNumber, messageHeader, MSG_DONTWAIT)};
+        if (bytesWritten != -1) {
             return bytesWritten;
+        } else if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != ECONNREFUSED)) {
+            //A connected socket reports an earlier ICMP port unreachable on the next send, which is worth one more try
+            break;
         }
     } while (retryCount++ < UDPClient::SEND_RETRY_COUNT);
     return 0;
 }
 
-ssize_t UDPClient::writeLine(const std::string &str)
+std::vector<ssize_t> UDPClient::writeBatch(const std::vector<std::string> &payloads)
+{
+    return this->writeBatch(payloads.data(), payloads.size(), nullptr);
+}
+
+std::vector<ssize_t> UDPClient::writeBatch(const std::vector<std::string> &payloads, const std::vector<UDPEndpoint> &destinations)
+{
+    if (destinations.size() != payloads.size()) {
+        throw std::runtime_error("In UDPClient::writeBatch(const std::vector<std::string> &, const std::vector<UDPEndpoint> &): there must be one destination per payload (" +
+                                 std::to_string(destinations.size())
+                                 + " != "
+                                 + std::to_string(payloads.size())
+                                 + ")");
+    }
+    return this->writeBatch(payloads.data(), payloads.size(), destinations.data());
+}
+
+std::vector<ssize_t> UDPClient::writeBatch(const std::string *payloads, size_t count, const UDPEndpoint *destinations)
+{
+    std::vector<ssize_t> results(count, 0);
+    if (this->m_isCoalescing.load(std::memory_order_relaxed)) {
+        this->flushCoalescedLines();
+    }
+#if defined(__linux__)
+    if ((this->m_sendGSO) && (!destinations)) {
+        this->writeSegmentedBatch(payloads, count, results.data());
+        return results;
+    }
+#endif
+    this->writeLineBatch(payloads, count, destinations, results.data(), true);
+    return results;
+}
+
+std::vector<ssize_t> UDPClient::writeToAll(const std::string &payload, const std::vector<UDPEndpoint> &endpoints)
+{
+    return this->writeToAll(payload.data(), payload.size(), endpoints.data(), endpoints.size());
+}
+
+std::vector<ssize_t> UDPClient::writeToAll(const char *data, size_t length, const UDPEndpoint *endpoints, size_t count)
+{
+    std::vector<ssize_t> results(count, 0);
+    if (this->m_isCoalescing.load(std::memory_order_relaxed)) {
+        this->flushCoalescedLines();
+    }
+    if (this->m_isAsyncSending.load(std::memory_order_relaxed)) {
+        for (size_t i = 0; i < count; i++) {
+            results[i] = this->enqueueSend(endpoints[i].socketAddress(), data, length, true);
+        }
+        return results;
+    }
+#if defined(__linux__)
+    //Every message points at the same iovecs, so the line is laid out once however many endpoints it goes to
+    iovec ioVectors[2]{ {const_cast<char *>(data), length},
+                        {const_cast<char *>(this->m_lineEnding.data()), this->m_lineEnding.size()} };
+    size_t ioVectorCount{endsWith(data, length, this->m_lineEnding) ? 1u : 2u};
+    size_t batchSize{std::min(count, UDPClient::SEND_BATCH_SIZE)};
+    std::vector<mmsghdr> messageHeaders(batchSize);
+    for (size_t batchStart = 0; batchStart < count; batchStart += batchSize) {
+        size_t chunkSize{std::min(count - batchStart, batchSize)};
+        for (size_t i = 0; i < chunkSize; i++) {
+            messageHeaders[i] = mmsghdr{};
+            messageHeaders[i].msg_hdr.msg_name = const_cast<sockaddr_in *>(&endpoints[batchStart + i].socketAddress());
+            messageHeaders[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messageHeaders[i].msg_hdr.msg_iov = ioVectors;
+            messageHeaders[i].msg_hdr.msg_iovlen = ioVectorCount;
+        }
+        this->sendDatagramBatch(messageHeaders.data(), chunkSize, &results[batchStart], true);
+    }
+#else
+    for (size_t i = 0; i < count; i++) {
+        results[i] = this->sendLine(endpoints[i].socketAddress(), data, length);
+    }
+#endif
+    return results;
+}
+
+void UDPClient::writeLineBatch(const std::string *payloads, size_t count, const UDPEndpoint *destinations, ssize_t *results, bool isPaced)
+{
+    //Each payload goes out as writeLine() would send it, with the line ending as a second iovec instead of a copy
+    //isPaced is false when the caller already took the send rate tokens for these payloads
+#if defined(__linux__)
+    size_t batchSize{std::min(count, UDPClient::SEND_BATCH_SIZE)};
+    std::vector<iovec> ioVectors(batchSize * 2);
+    std::vector<mmsghdr> messageHeaders(batchSize);
+    for (size_t batchStart = 0; batchStart < count; batchStart += batchSize) {
+        size_t chunkSize{std::min(count - batchStart, batchSize)};
+        for (size_t i = 0; i < chunkSize; i++) {
+            const std::string &payload{payloads[batchStart + i]};
+            iovec *messageVectors{&ioVectors[i * 2]};
+            messageVectors[0].iov_base = const_cast<char *>(payload.data());
+            messageVectors[0].iov_len = payload.size();
+            messageVectors[1].iov_base = const_cast<char *>(this->m_lineEnding.data());
+            messageVectors[1].iov_len = this->m_lineEnding.size();
+            messageHeaders[i] = mmsghdr{};
+            messageHeaders[i].msg_hdr.msg_name = (destinations ? const_cast<sockaddr_in *>(&destinations[batchStart + i].socketAddress()) : this->sendAddress());
+            messageHeaders[i].msg_hdr.msg_namelen = (messageHeaders[i].msg_hdr.msg_name ? sizeof(sockaddr_in) : 0);
+            messageHeaders[i].msg_hdr.msg_iov = messageVectors;
+            messageHeaders[i].msg_hdr.msg_iovlen = (endsWith(payload, this->m_lineEnding) ? 1 : 2);
+        }
+        this->sendDatagramBatch(messageHeaders.data(), chunkSize, &results[batchStart], isPaced);
+    }
+#else
+    for (size_t i = 0; i < count; i++) {
+        results[i] = this->sendLine((destinations ? destinations[i].socketAddress() : this->m_destinationAddress), payloads[i].data(), payloads[i].size());
+    }
+#endif
+}
+
+#if defined(__linux__)
+void UDPClient::sendDatagramBatch(mmsghdr *messageHeaders, size_t count, ssize_t *results, bool isPaced)
+{
+    size_t sentCount{0};
+    size_t pacedCount{isPaced ? 0 : count};
+    unsigned int retryCount{0};
+    while (sentCount < count) {
+        if (sentCount == pacedCount) {
+            pacedCount += this->pacedMessageCount(&messageHeaders[sentCount], count - sentCount);
+        }
+        if (this->m_ioUring) {
+            this->m_ioUring->sendMessages(this->m_udpSocketIndex, &messageHeaders[sentCount], pacedCount - sentCount, &results[sentCount]);
+            for (size_t i = sentCount; i < pacedCount; i++) {
+                results[i] = std::max<ssize_t>(results[i], 0);
+            }
+            sentCount = pacedCount;
+            continue;
+        }
+        int returnValue{sendmmsg(this->m_udpSocketIndex, &messageHeaders[sentCount], static_cast<unsigned int>(pacedCount - sentCount), MSG_DONTWAIT)};
+        if (returnValue > 0) {
+            for (int i = 0; i < returnValue; i++) {
+                results[sentCount + i] = messageHeaders[sentCount + i].msg_len;
+            }
+            sentCount += returnValue;
+            retryCount = 0;
+        } else if (((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == ECONNREFUSED)) && (retryCount++ < UDPClient::SEND_RETRY_COUNT)) {
+            continue;
+        } else {
+            //sendmmsg stops at the first failing message, so report it like sendDatagram() would and carry on
+            results[sentCount++] = 0;
+            retryCount = 0;
+        }
+    }
+}
+
+size_t UDPClient::pacedMessageCount(const mmsghdr *messageHeaders, size_t count)
+{
+    //With a send rate set, a batch leaves in the slices the token bucket admits instead of as one burst
+    if (!this->m_sendPacer.isEnabled()) {
+        return count;
+    }
+    return this->m_sendPacer.acquire(count, [messageHeaders](size_t index) { return messageLength(messageHeaders[index].msg_hdr); });
+}
+#endif
+
+#if defined(__linux__)
+void UDPClient::writeSegmentedBatch(const std::string *payloads, size_t count, ssize_t *results)
+{
+    std::vector<iovec> ioVectors(UDPClient::MAXIMUM_GSO_SEGMENTS * 2);
+    size_t runStart{0};
+    while (runStart < count) {
+        //Runs of equal sized lines go out as one UDP_SEGMENT send, anything else takes the sendmmsg path
+        size_t segmentSize{payloads[runStart].size() + (endsWith(payloads[runStart], this->m_lineEnding) ? 0 : this->m_lineEnding.size())};
+        size_t runLength{1};
+        while ((runStart + runLength < count) &&
+               (runLength < UDPClient::MAXIMUM_GSO_SEGMENTS) &&
+               ((runLength + 1) * segmentSize <= UDPClient::MAXIMUM_GSO_PAYLOAD)) {
+            const std::string &nextPayload{payloads[runStart + runLength]};
+            if (nextPayload.size() + (endsWith(nextPayload, this->m_lineEnding) ? 0 : this->m_lineEnding.size()) != segmentSize) {
+                break;
+            }
+            runLength++;
+        }
+        bool isPaced{true};
+        if ((this->m_sendGSO) && (runLength > 1) && (segmentSize > 0) && (segmentSize <= this->m_gsoSegmentLimit)) {
+            if (this->m_sendPacer.isEnabled()) {
+                //A paced run shrinks to what the token bucket admits, so one UDP_SEGMENT send is never a bigger burst
+                runLength = this->m_sendPacer.acquire(runLength, [segmentSize](size_t) { return segmentSize; });
+                isPaced = false;
+            }
+            if (this->sendSegmented(&payloads[runStart], runLength, segmentSize, ioVectors.data()) > 0) {
+                std::fill(results + runStart, results + runStart + runLength, static_cast<ssize_t>(segmentSize));
+                runStart += runLength;
+                continue;
+            }
+        }
+        //A failed UDP_SEGMENT send is retried as plain sends, with the tokens it already took
+        this->writeLineBatch(&payloads[runStart], runLength, nullptr, &results[runStart], isPaced);
+        runStart += runLength;
+    }
+}
+
+ssize_t UDPClient::sendSegmented(const std::string *payloads, size_t count, size_t segmentSize, iovec *ioVectors)
+{
+    size_t ioVectorCount{0};
+    for (size_t i = 0; i < count; i++) {
+        ioVectors[ioVectorCount].iov_base = const_cast<char *>(payloads[i].data());
+        ioVectors[ioVectorCount].iov_len = payloads[i].size();
+        ioVectorCount++;
+        if (!endsWith(payloads[i], this->m_lineEnding)) {
+            ioVectors[ioVectorCount].iov_base = const_cast<char *>(this->m_lineEnding.data());
+            ioVectors[ioVectorCount].iov_len = this->m_lineEnding.size();
+            ioVectorCount++;
+        }
+    }
+    union {
+        cmsghdr alignment;
+        char buffer[CMSG_SPACE(sizeof(uint16_t))];
+    } control{};
+    msghdr messageHeader{};
+    messageHeader.msg_name = this->sendAddress();
+    messageHeader.msg_namelen = (this->m_isConnected ? 0 : sizeof(this->m_destinationAddress));
+    messageHeader.msg_iov = ioVectors;
+    messageHeader.msg_iovlen = ioVectorCount;
+    messageHeader.msg_control = control.buffer;
+    messageHeader.msg_controllen = sizeof(control.buffer);
+    cmsghdr *controlMessage{CMSG_FIRSTHDR(&messageHeader)};
+    controlMessage->cmsg_level = SOL_UDP;
+    controlMessage->cmsg_type = UDP_SEGMENT;
+    controlMessage->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    uint16_t gsoSize{static_cast<uint16_t>(segmentSize)};
+    memcpy(CMSG_DATA(controlMessage), &gsoSize, sizeof(gsoSize));
+    unsigned int retryCount{0};
+    do {
+        ssize_t bytesWritten{sendmsg(this->m_udpSocketIndex, &messageHeader, MSG_DONTWAIT)};
+        if (bytesWritten != -1) {
+            return bytesWritten;
+        } else if ((errno == EINVAL) && (segmentSize > this->pathSegmentLimit())) {
+            //The segment does not fit the path MTU, so only segments that do still use UDP_SEGMENT
+            this->m_gsoSegmentLimit = this->pathSegmentLimit();
+            break;
+        } else if ((errno == EIO) || (errno == EINVAL)) {
+            //No checksum offload on the route, or a kernel without UDP_SEGMENT, so stay on plain sends from here on
+            this->m_sendGSO = false;
+            break;
+        } else if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != ECONNREFUSED)) {
+            break;
+        }
+    } while (retryCount++ < UDPClient::SEND_RETRY_COUNT);
+    return 0;
+}
+
+size_t UDPClient::pathSegmentLimit() const
+{
+    //IP_MTU only answers on a connected socket, otherwise assume an Ethernet sized path
+    int pathMtu{0};
+    socklen_t optionLength{sizeof(pathMtu)};
+    if ((!this->m_isConnected) || (getsockopt(this->m_udpSocketIndex, IPPROTO_IP, IP_MTU, &pathMtu, &optionLength) != 0) || (pathMtu <= static_cast<int>(UDPClient::IPV4_UDP_HEADER_SIZE))) {
+        pathMtu = static_cast<int>(UDPClient::DEFAULT_PATH_MTU);
+    }
+    return static_cast<size_t>(pathMtu) - UDPClient::IPV4_UDP_HEADER_SIZE;
+}
+#endif
+
+void UDPClient::setSendGSO(bool sendGSO)
+{
+#if !defined(__linux__) || !defined(UDP_SEGMENT)
+    if (sendGSO) {
+        throw std::runtime_error("In UDPClient::setSendGSO(bool): UDP_SEGMENT is not supported on this platform");
+    }
+#endif
+    this->m_sendGSO = sendGSO;
+}
+
+bool UDPClient::sendGSO() const
 {
-    this->writeLine(this->hostName(), this->portNumber(), str);
+    return this->m_sendGSO;
 }
 
 bool constexpr UDPClient::isValidPortNumber(int portNumber)
@@ -1125,7 +3366,13 @@ std::shared_ptr<UDPClient> UDPClient::doUserSelectUDPClient()
 
 UDPClient::~UDPClient()
 {
-    shutdown(this->m_udpSocketIndex, SHUT_RDWR);
+    this->setLineCoalescing(0);
+    this->stopAsyncSend();
+    //Completions the kernel has not reported by now are never called, so their payloads stay with the caller
+    this->m_zeroCopyTracker.waitForCompletions(std::chrono::milliseconds{UDPClient::ZERO_COPY_DRAIN_TIMEOUT});
+    if (this->m_ownsSocket) {
+        shutdown(this->m_udpSocketIndex, SHUT_RDWR);
+    }
 }
 
 
@@ -1191,13 +3438,20 @@ UDPDuplex::UDPDuplex(const std::string &clientHostName, uint16_t clientPortNumbe
     m_udpServer{nullptr},
     m_udpObjectType{udpObjectType}
 {
-    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
         this->m_udpClient = std::unique_ptr<UDPClient>{new UDPClient{clientHostName, 
                                                                      clientPortNumber,
                                                                      clientReturnAddressPortNumber}};
     }
-    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if (this->m_udpObjectType == UDPObjectType::SingleSocketDuplex) {
+        //The client sends from the bound server socket, so replies come back to serverPortNumber, and every read
+        //below that goes to the client socket is served by that one socket, listener thread and queue
+        this->m_udpServer = std::unique_ptr<UDPServer>{new UDPServer{serverPortNumber}};
+        this->m_udpClient->shareSocket(this->m_udpServer->m_socketNumber);
+    } else if ((this->m_udpObjectType == UDPObjectType::Server) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
         if (this->m_udpClient != nullptr) {
+            //Replies are read on the client socket, and a connected socket would drop any that come from another port
+            this->m_udpClient->setConnectToDestination(false);
             this->m_udpServer = std::unique_ptr<UDPServer>{new UDPServer{}};
         } else {
             this->m_udpServer = std::unique_ptr<UDPServer>{new UDPServer{serverPortNumber}};
@@ -1266,32 +3520,46 @@ bool UDPDuplex::isOpen() const
 
 void UDPDuplex::setClientPortNumber(uint16_t portNumber)
 {
-    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
        this->m_udpClient->setPortNumber(portNumber);
     }
 }
 
 void UDPDuplex::setClientHostName(const std::string &hostName)
 {
-    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
         this->m_udpClient->setHostName(hostName);
     }
 }
 
 void UDPDuplex::setClientReturnAddressPortNumber(uint16_t portNumber)
 {
-    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
        this->m_udpClient->setReturnAddressPortNumber(portNumber);
     }
 }
 
 void UDPDuplex::setClientTimeout(long timeout)
 {
-    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
         this->m_udpClient->setTimeout(timeout);   
     }
 }
 
+void UDPDuplex::setClientSendRate(double packetsPerSecond, double bytesPerSecond)
+{
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
+        this->m_udpClient->setSendRate(packetsPerSecond, bytesPerSecond);
+    }
+}
+
+void UDPDuplex::setClientLineCoalescing(size_t coalescedDatagramSize, std::chrono::microseconds coalesceDelay)
+{
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
+        this->m_udpClient->setLineCoalescing(coalescedDatagramSize, coalesceDelay);
+    }
+}
+
 void UDPDuplex::setTimeout(long timeout)
 {
     if (this->m_udpObjectType == UDPObjectType::Server) {
@@ -1301,12 +3569,13 @@ void UDPDuplex::setTimeout(long timeout)
     } else {
         this->m_udpClient->setTimeout(timeout);
         this->m_udpServer->setTimeout(timeout);
+        this->m_udpServer->setTimeout(this->m_udpClient->m_udpSocketIndex, timeout);
     }
 }
 
 uint16_t UDPDuplex::clientPortNumber() const
 {
-    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
         return this->m_udpClient->portNumber();
     } else {
         return 0;
@@ -1315,7 +3584,7 @@ uint16_t UDPDuplex::clientPortNumber() const
 
 std::string UDPDuplex::clientHostName() const
 {
-    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
         return this->m_udpClient->hostName();
     } else {
         return "";
@@ -1324,7 +3593,7 @@ std::string UDPDuplex::clientHostName() const
     
 uint16_t UDPDuplex::clientReturnAddressPortNumber() const
 {
-    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
         return this->m_udpClient->m_udpSocketIndex;
     } else {
         return 0;
@@ -1333,7 +3602,7 @@ uint16_t UDPDuplex::clientReturnAddressPortNumber() const
 
 long UDPDuplex::clientTimeout() const
 {
-    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
         return this->m_udpClient->timeout();
     } else {
         return 0;
@@ -1342,7 +3611,7 @@ long UDPDuplex::clientTimeout() const
 
 uint16_t UDPDuplex::serverPortNumber() const
 {
-    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
         return this->m_udpServer->portNumber();   
     } else {
         return 0;
@@ -1351,16 +3620,55 @@ uint16_t UDPDuplex::serverPortNumber() const
 
 long UDPDuplex::serverTimeout() const
 {
-    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
         return this->m_udpServer->timeout();
     } else {
         return 0;
     }
 }
 
+void UDPDuplex::setServerReceiveQueueLimit(size_t maximumDatagramCount, size_t maximumByteCount)
+{
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
+        this->m_udpServer->setReceiveQueueLimit(maximumDatagramCount, maximumByteCount);
+    }
+}
+
+void UDPDuplex::setServerReceiveQueuePolicy(ReceiveQueuePolicy receiveQueuePolicy)
+{
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
+        this->m_udpServer->setReceiveQueuePolicy(receiveQueuePolicy);
+    }
+}
+
+uint64_t UDPDuplex::droppedDatagramCount() const
+{
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
+        return this->m_udpServer->droppedDatagramCount();
+    } else {
+        return 0;
+    }
+}
+
+uint64_t UDPDuplex::droppedByteCount() const
+{
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
+        return this->m_udpServer->droppedByteCount();
+    } else {
+        return 0;
+    }
+}
+
+void UDPDuplex::clearServerDatagramHandler()
+{
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
+        this->m_udpServer->clearDatagramHandler();
+    }
+}
+
 void UDPDuplex::setServerPortNumber(uint16_t portNumber)
 {
-    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
         this->m_udpServer->setPortNumber(portNumber);
     }
 }
@@ -1369,7 +3677,7 @@ void UDPDuplex::setServerTimeout(long timeout)
 {
     if (this->m_udpObjectType == UDPObjectType::Server) {
         this->m_udpServer->setTimeout(timeout); 
-    } else if (this->m_udpObjectType == UDPObjectType::Duplex) {
+    } else if (this->isDuplex()) {
         this->m_udpServer->setTimeout(this->m_udpClient->m_udpSocketIndex, timeout);
     }
 }
@@ -1389,7 +3697,7 @@ long UDPDuplex::timeout() const
 
 std::string UDPDuplex::portName() const
 {   
-    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
         return this->m_udpClient->hostName();
     } else {
         return "server - no port name";
@@ -1398,28 +3706,28 @@ std::string UDPDuplex::portName() const
 
 void UDPDuplex::flushRXTX()
 {
-    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
         this->m_udpServer->flushRXTX();
     }
 } 
 
 void UDPDuplex::flushRX()
 {
-    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
         this->m_udpServer->flushRX();
     }
 }
 
 void UDPDuplex::flushTX()
 {
-    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
         this->m_udpServer->flushTX();
     }
 }  
 
 ssize_t UDPDuplex::writeLine(const std::string &hostName, uint16_t portNumber, const char *str)
 { 
-    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
         return this->m_udpClient->writeLine(hostName, portNumber, str); 
     } else {
         return 0;
@@ -1428,7 +3736,7 @@ ssize_t UDPDuplex::writeLine(const std::string &hostName, uint16_t portNumber, c
 
 ssize_t UDPDuplex::writeLine(const std::string &hostName, uint16_t portNumber, const std::string &str)
 {
-    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
         return this->m_udpClient->writeLine(hostName, portNumber, str);
     } else {
         return 0;
@@ -1437,8 +3745,8 @@ ssize_t UDPDuplex::writeLine(const std::string &hostName, uint16_t portNumber, c
 
 ssize_t UDPDuplex::writeLine(const char *str)
 { 
-    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
-        return this->m_udpClient->writeLine(this->m_udpClient->hostName(), this->m_udpClient->portNumber(), str); 
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
+        return this->m_udpClient->writeLine(str); 
     } else {
         return 0;
     }
@@ -1446,8 +3754,67 @@ ssize_t UDPDuplex::writeLine(const char *str)
 
 ssize_t UDPDuplex::writeLine(const std::string &str)
 {
-    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
-        return this->m_udpClient->writeLine(this->m_udpClient->hostName(), this->m_udpClient->portNumber(), str); 
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
+        return this->m_udpClient->writeLine(str); 
+    } else {
+        return 0;
+    }
+}
+
+ssize_t UDPDuplex::write(const void *data, size_t length)
+{
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
+        return this->m_udpClient->write(data, length);
+    } else {
+        return 0;
+    }
+}
+
+ssize_t UDPDuplex::writeZeroCopy(const void *data, size_t length, ZeroCopyCompletion completion)
+{
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
+        return this->m_udpClient->writeZeroCopy(data, length, std::move(completion));
+    } else {
+        if (completion) {
+            completion(data, length, true);
+        }
+        return 0;
+    }
+}
+
+std::vector<ssize_t> UDPDuplex::writeToAll(const std::string &payload, const std::vector<UDPEndpoint> &endpoints)
+{
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
+        return this->m_udpClient->writeToAll(payload, endpoints);
+    } else {
+        return std::vector<ssize_t>(endpoints.size(), 0);
+    }
+}
+
+std::vector<ssize_t> UDPDuplex::writeBatch(const std::vector<std::string> &payloads)
+{
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
+        return this->m_udpClient->writeBatch(payloads);
+    } else {
+        return std::vector<ssize_t>(payloads.size(), 0);
+    }
+}
+
+std::vector<ssize_t> UDPDuplex::writeBatch(const std::vector<std::string> &payloads, const std::vector<UDPEndpoint> &destinations)
+{
+    if ((this->m_udpObjectType == UDPObjectType::Client) || (this->isDuplex())) {
+        return this->m_udpClient->writeBatch(payloads, destinations);
+    } else {
+        return std::vector<ssize_t>(payloads.size(), 0);
+    }
+}
+
+ssize_t UDPDuplex::readDatagramInto(void *buffer, size_t length)
+{
+    if (this->m_udpObjectType == UDPObjectType::Server) {
+        return this->m_udpServer->readDatagramInto(buffer, length);
+    } else if (this->isDuplex()) {
+        return this->m_udpServer->readDatagramInto(this->m_udpClient->m_udpSocketIndex, buffer, length);
     } else {
         return 0;
     }
@@ -1457,7 +3824,7 @@ UDPDatagram UDPDuplex::readDatagram()
 {
     if (this->m_udpObjectType == UDPObjectType::Server) {
         return this->m_udpServer->readDatagram();
-    } else if (this->m_udpObjectType == UDPObjectType::Duplex) {
+    } else if (this->isDuplex()) {
         return this->m_udpServer->readDatagram(this->m_udpClient->m_udpSocketIndex);
     } else {
         return UDPDatagram{};
@@ -1468,7 +3835,7 @@ char UDPDuplex::readByte()
 {
     if (this->m_udpObjectType == UDPObjectType::Server) {
         return this->m_udpServer->readByte();
-    } else if (this->m_udpObjectType == UDPObjectType::Duplex) {
+    } else if (this->isDuplex()) {
         return this->m_udpServer->readByte(this->m_udpClient->m_udpSocketIndex);
     } else {
         return 0;
@@ -1479,7 +3846,7 @@ std::string UDPDuplex::readLine()
 {
     if (this->m_udpObjectType == UDPObjectType::Server) {
         return this->m_udpServer->readLine();
-    } else if (this->m_udpObjectType == UDPObjectType::Duplex) {
+    } else if (this->isDuplex()) {
         return this->m_udpServer->readLine(this->m_udpClient->m_udpSocketIndex);
     } else {
         return "";
@@ -1490,7 +3857,7 @@ std::string UDPDuplex::readUntil(const std::string &str)
 {
     if (this->m_udpObjectType == UDPObjectType::Server) {
         return this->m_udpServer->readUntil(str);
-    } else if (this->m_udpObjectType == UDPObjectType::Duplex) {
+    } else if (this->isDuplex()) {
         return this->m_udpServer->readUntil(this->m_udpClient->m_udpSocketIndex, str);
     } else {
         return "";
@@ -1501,7 +3868,7 @@ std::string UDPDuplex::readUntil(const char *str)
 {
     if (this->m_udpObjectType == UDPObjectType::Server) {
         return this->m_udpServer->readUntil(str);
-    } else if (this->m_udpObjectType == UDPObjectType::Duplex) {
+    } else if (this->isDuplex()) {
         return this->m_udpServer->readUntil(this->m_udpClient->m_udpSocketIndex, str);
     }  else {
         return "";
@@ -1512,37 +3879,75 @@ std::string UDPDuplex::readUntil(char until)
 {
     if (this->m_udpObjectType == UDPObjectType::Server) {
         return this->m_udpServer->readUntil(until);
-    } else if (this->m_udpObjectType == UDPObjectType::Duplex) {
+    } else if (this->isDuplex()) {
         return this->m_udpServer->readUntil(this->m_udpClient->m_udpSocketIndex, until);
     } else {
         return "";
     }
 }
 
+UDPLineView UDPDuplex::readLineView()
+{
+    if (this->m_udpObjectType == UDPObjectType::Server) {
+        return this->m_udpServer->readLineView();
+    } else if (this->isDuplex()) {
+        return this->m_udpServer->readLineView(this->m_udpClient->m_udpSocketIndex);
+    } else {
+        return UDPLineView{};
+    }
+}
+
+UDPLineView UDPDuplex::readUntilView(const std::string &until)
+{
+    if (this->m_udpObjectType == UDPObjectType::Server) {
+        return this->m_udpServer->readUntilView(until);
+    } else if (this->isDuplex()) {
+        return this->m_udpServer->readUntilView(this->m_udpClient->m_udpSocketIndex, until);
+    } else {
+        return UDPLineView{};
+    }
+}
+
+void UDPDuplex::setStreamingLines(bool streamingLines)
+{
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
+        this->m_udpServer->setStreamingLines(streamingLines);
+    }
+}
+
+bool UDPDuplex::streamingLines() const
+{
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
+        return this->m_udpServer->streamingLines();
+    } else {
+        return false;
+    }
+}
+
 void UDPDuplex::putBack(const UDPDatagram &datagram)
 {
-    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
         return this->m_udpServer->putBack(datagram);
     }
 }
 
 void UDPDuplex::putBack(const std::string &str)
 {
-    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
         return this->m_udpServer->putBack(str);
     }
 }
 
 void UDPDuplex::putBack(const char *str)
 {
-    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
         return this->m_udpServer->putBack(str);
     }
 }
 
 void UDPDuplex::putBack(char back)
 {
-    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
         return this->m_udpServer->putBack(back);
     }
 }
@@ -1551,7 +3956,7 @@ std::string UDPDuplex::peek()
 {
     if (this->m_udpObjectType == UDPObjectType::Server) {
         return this->m_udpServer->peek();
-    } else if (this->m_udpObjectType == UDPObjectType::Duplex) {
+    } else if (this->isDuplex()) {
         return this->m_udpServer->peek(this->m_udpClient->m_udpSocketIndex);
     } else {
         return "";
@@ -1562,7 +3967,7 @@ UDPDatagram UDPDuplex::peekDatagram()
 {
     if (this->m_udpObjectType == UDPObjectType::Server) {
         return this->m_udpServer->peekDatagram();
-    } else if (this->m_udpObjectType == UDPObjectType::Duplex) {
+    } else if (this->isDuplex()) {
         return this->m_udpServer->peekDatagram(this->m_udpClient->m_udpSocketIndex);
     } else {
         return UDPDatagram{};
@@ -1573,7 +3978,7 @@ char UDPDuplex::peekByte()
 {
     if (this->m_udpObjectType == UDPObjectType::Server) {
         return this->m_udpServer->peekByte();
-    } else if (this->m_udpObjectType == UDPObjectType::Duplex) {
+    } else if (this->isDuplex()) {
         return this->m_udpServer->peekByte(this->m_udpClient->m_udpSocketIndex);
     } else {
         return 0;
@@ -1584,32 +3989,43 @@ ssize_t UDPDuplex::available()
 {
     if (this->m_udpObjectType == UDPObjectType::Server) {
         return this->m_udpServer->available();
-    } else if (this->m_udpObjectType == UDPObjectType::Duplex) {
+    } else if (this->isDuplex()) {
         return this->m_udpServer->available(this->m_udpClient->m_udpSocketIndex);
     } else {
         return 0;
     }
 }
 
+bool UDPDuplex::waitForDatagram(std::chrono::nanoseconds timeout)
+{
+    if (this->m_udpObjectType == UDPObjectType::Server) {
+        return this->m_udpServer->waitForDatagram(timeout);
+    } else if (this->isDuplex()) {
+        return this->m_udpServer->waitForDatagram(this->m_udpClient->m_udpSocketIndex, timeout);
+    } else {
+        return false;
+    }
+}
+
 void UDPDuplex::startListening()
 {
     if (this->m_udpObjectType == UDPObjectType::Server) {
         this->m_udpServer->startListening();
-    } else if (this->m_udpObjectType == UDPObjectType::Duplex) {
+    } else if (this->isDuplex()) {
         this->m_udpServer->startListening(this->m_udpClient->m_udpSocketIndex);
     }
 }
 
 void UDPDuplex::stopListening()
 {
-    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
         return this->m_udpServer->stopListening();
     }
 }
 
 bool UDPDuplex::isListening() const
 {
-    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->m_udpObjectType == UDPObjectType::Duplex)) {
+    if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
         return this->m_udpServer->isListening();    
     } else {
         return 0;
@@ -1621,6 +4037,11 @@ UDPObjectType UDPDuplex::udpObjectType() const
     return this->m_udpObjectType;
 }
 
+bool UDPDuplex::isDuplex() const
+{
+    return ((this->m_udpObjectType == UDPObjectType::Duplex) || (this->m_udpObjectType == UDPObjectType::SingleSocketDuplex));
+}
+
 bool constexpr UDPDuplex::isValidPortNumber(int portNumber)
 {
     return ((portNumber > 0) && (portNumber < std::numeric_limits<uint16_t>::max()));
@@ -1650,7 +4071,8 @@ UDPObjectType UDPDuplex::doUserSelectUDPObjectType()
 {
     std::vector<std::string> udpObjectTypeChoices{UDPDuplex::udpObjectTypeToString(UDPObjectType::Duplex),
                                                   UDPDuplex::udpObjectTypeToString(UDPObjectType::Server),
-                                                  UDPDuplex::udpObjectTypeToString(UDPObjectType::Client)};
+                                                  UDPDuplex::udpObjectTypeToString(UDPObjectType::Client),
+                                                  UDPDuplex::udpObjectTypeToString(UDPObjectType::SingleSocketDuplex)};
     return doUserSelectParameter("UDP Object Type",
                                                     static_cast< std::function<UDPObjectType(const std::string &)> >(UDPDuplex::parseUDPObjectTypeFromRaw),
                                                     udpObjectTypeChoices,
@@ -1662,7 +4084,7 @@ std::shared_ptr<UDPDuplex> UDPDuplex::doUserSelectUDPDuplex()
 {
     std::shared_ptr<UDPDuplex> udpDuplex{nullptr};
     UDPObjectType udpObjectType{UDPDuplex::doUserSelectUDPObjectType()};
-    if (udpObjectType == UDPObjectType::Duplex) {
+    if ((udpObjectType == UDPObjectType::Duplex) || (udpObjectType == UDPObjectType::SingleSocketDuplex)) {
         std::string clientHostName{UDPDuplex::doUserSelectClientHostName()};
         uint16_t clientPortNumber{UDPDuplex::doUserSelectClientPortNumber()};
         uint16_t clientReturnAddressPortNumber{UDPDuplex::doUserSelectClientReturnAddressPortNumber()};
@@ -1707,6 +4129,8 @@ UDPObjectType UDPDuplex::parseUDPObjectTypeFromRaw(const std::string &udpObjectT
         return UDPObjectType::Server;
     } else if (secondCopy == "udpclient") {
         return UDPObjectType::Client;
+    } else if (secondCopy == "udpsinglesocketduplex") {
+        return UDPObjectType::SingleSocketDuplex;
     } else {
         throw std::runtime_error("Could not parse UDPObjectType in UDPDuplex::parseUDPObjectTypeFromRaw(const std::string &): unknown identifier " + tQuoted(udpObjectType));
     }
@@ -1720,6 +4144,8 @@ std::string UDPDuplex::udpObjectTypeToString(UDPObjectType udpObjectType)
         return "UDP Server";
     } else if (udpObjectType == UDPObjectType::Client) {
         return "UDP Client";
+    } else if (udpObjectType == UDPObjectType::SingleSocketDuplex) {
+        return "UDP Single Socket Duplex";
     } else {
         throw std::runtime_error("Unknown UDPObjectType passed to UDPDuplex::udpObjectTypeToString(UDPObjectType)");
     }
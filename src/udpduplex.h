@@ -25,6 +25,12 @@
 #include <sstream>
 #include <deque>
 #include <future>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #if defined (_WIN32)
 
@@ -40,11 +46,48 @@
 #endif //defined(_WIN32)
 
 #include "ibytestream.h"
+#include "spscringbuffer.h"
+#include "mpmcringbuffer.h"
+#include "datagrambufferpool.h"
+#include "udpendpointcache.h"
+#include "udppacer.h"
+#include "udpzerocopy.h"
+
+class UDPReactor;
+class ReceiveOverflowBuffers;
+#if defined(__linux__)
+    class UDPIoUring;
+    struct UDPIoUringMessage;
+#endif
 
 enum class UDPObjectType {
     Duplex,
     Server,
-    Client
+    Client,
+    SingleSocketDuplex
+};
+
+enum class DatagramQueueType {
+    Deque,
+    RingBuffer
+};
+
+enum class UDPIOEngine {
+    Socket,
+    IoUring
+};
+
+enum class SendQueuePolicy {
+    Block,
+    DropNewest,
+    DropOldest
+};
+
+/*What the listener does with a datagram that would push the receive queue past its limit*/
+enum class ReceiveQueuePolicy {
+    DropOldest,
+    DropNewest,
+    BlockListener
 };
 
 
@@ -58,23 +101,65 @@ enum class UDPObjectType {
 
 class UDPDatagram
 {
+    friend class UDPServer;
+    friend class UDPDatagramView;
 public:
     UDPDatagram(struct sockaddr_in socketAddress, const std::string &message) :
-        m_message{message}
+        m_payload{message.data(), message.size()}
     { 
        this->m_socketAddress.sin_family = socketAddress.sin_family;
        this->m_socketAddress.sin_port = socketAddress.sin_port;
        this->m_socketAddress.sin_addr.s_addr = socketAddress.sin_addr.s_addr;
     }
 
+    UDPDatagram(struct sockaddr_in socketAddress, const char *data, size_t length) :
+        m_payload{data, length}
+    {
+       this->m_socketAddress.sin_family = socketAddress.sin_family;
+       this->m_socketAddress.sin_port = socketAddress.sin_port;
+       this->m_socketAddress.sin_addr.s_addr = socketAddress.sin_addr.s_addr;
+    }
+
+    UDPDatagram(struct sockaddr_in socketAddress, DatagramBuffer &&payload) :
+        m_payload{std::move(payload)}
+    {
+       this->m_socketAddress.sin_family = socketAddress.sin_family;
+       this->m_socketAddress.sin_port = socketAddress.sin_port;
+       this->m_socketAddress.sin_addr.s_addr = socketAddress.sin_addr.s_addr;
+    }
+
     UDPDatagram() :
-        m_message{""} 
+        m_payload{} 
     { 
        this->m_socketAddress.sin_family = 0;
        this->m_socketAddress.sin_port = 0;
        this->m_socketAddress.sin_addr.s_addr = 0;
     }
 
+    /*Copies never share pooled storage, so a copy can outlive the pool slot it came from*/
+    UDPDatagram(const UDPDatagram &other) :
+        m_socketAddress(other.m_socketAddress),
+        m_payload{other.m_payload.clone()},
+        m_receiveTimestamp{other.m_receiveTimestamp},
+        m_queueTimestamp{other.m_queueTimestamp}
+    {
+
+    }
+
+    UDPDatagram &operator=(const UDPDatagram &other)
+    {
+        if (this != &other) {
+            this->m_socketAddress = other.m_socketAddress;
+            this->m_payload = other.m_payload.clone();
+            this->m_receiveTimestamp = other.m_receiveTimestamp;
+            this->m_queueTimestamp = other.m_queueTimestamp;
+        }
+        return *this;
+    }
+
+    UDPDatagram(UDPDatagram &&other) = default;
+    UDPDatagram &operator=(UDPDatagram &&other) = default;
+
     struct sockaddr_in socketAddress () const 
     {
         sockaddr_in returnSocket;
@@ -85,7 +170,15 @@ public:
     }
 
     uint16_t portNumber() const { return ntohs(this->m_socketAddress.sin_port); }
-    std::string message() const { return this->m_message; }
+    std::string message() const { return std::string{this->m_payload.data(), this->m_payload.size()}; }
+    const char *data() const { return this->m_payload.data(); }
+    size_t size() const { return this->m_payload.size(); }
+    bool isPooled() const { return this->m_payload.isPooled(); }
+    DatagramBuffer releasePayload() { return std::move(this->m_payload); }
+    /*Both are CLOCK_REALTIME, the kernel stamp when the datagram arrived and the stamp when it was queued for readers*/
+    std::chrono::system_clock::time_point receiveTimestamp() const { return this->m_receiveTimestamp; }
+    std::chrono::system_clock::time_point queueTimestamp() const { return this->m_queueTimestamp; }
+    bool hasReceiveTimestamp() const { return this->m_receiveTimestamp.time_since_epoch().count() != 0; }
     std::string hostName() const  { 
         char lowLevelTempBuffer[INET_ADDRSTRLEN];
         memset(lowLevelTempBuffer, '\0', INET_ADDRSTRLEN);
@@ -95,31 +188,165 @@ public:
 
 private:
     struct sockaddr_in m_socketAddress;
-    std::string m_message;
+    DatagramBuffer m_payload;
+    std::chrono::system_clock::time_point m_receiveTimestamp;
+    std::chrono::system_clock::time_point m_queueTimestamp;
+};
+
+
+class UDPEndpoint
+{
+public:
+    UDPEndpoint(const std::string &hostName, uint16_t portNumber);
+    explicit UDPEndpoint(const sockaddr_in &socketAddress);
+
+    std::string hostName() const;
+    uint16_t portNumber() const;
+    const sockaddr_in &socketAddress() const { return this->m_socketAddress; }
+
+private:
+    sockaddr_in m_socketAddress;
+};
+
+/*A line handed out without copying it, valid until the next read of any kind from the UDPServer it came from, so it
+  is only safe when that server has a single reader thread. The listener never evicts the datagram behind it*/
+class UDPLineView
+{
+public:
+    UDPLineView() :
+        m_data{nullptr},
+        m_size{0}
+    {
+
+    }
+
+    UDPLineView(const char *data, size_t size) :
+        m_data{data},
+        m_size{size}
+    {
+
+    }
+
+    const char *data() const { return this->m_data; }
+    size_t size() const { return this->m_size; }
+    bool empty() const { return this->m_size == 0; }
+    std::string toString() const { return (this->m_size == 0 ? std::string{} : std::string{this->m_data, this->m_size}); }
+
+private:
+    const char *m_data;
+    size_t m_size;
+};
+
+/*A received datagram handed to a datagram handler without copying it, valid only until the handler returns*/
+class UDPDatagramView
+{
+public:
+    explicit UDPDatagramView(const UDPDatagram &datagram) :
+        m_datagram{&datagram}
+    {
+
+    }
+
+    const char *data() const { return this->m_datagram->data(); }
+    size_t size() const { return this->m_datagram->size(); }
+    const sockaddr_in &socketAddress() const { return this->m_datagram->m_socketAddress; }
+    uint16_t portNumber() const { return this->m_datagram->portNumber(); }
+    std::string hostName() const { return this->m_datagram->hostName(); }
+    std::chrono::system_clock::time_point receiveTimestamp() const { return this->m_datagram->receiveTimestamp(); }
+    std::string message() const { return this->m_datagram->message(); }
+    /*Copies the payload out, for a handler that keeps the datagram past its return*/
+    UDPDatagram toDatagram() const { return UDPDatagram{*this->m_datagram}; }
+
+private:
+    const UDPDatagram *m_datagram;
+};
+
+/*Owns a datagram handler behind one plain function pointer, so the handler's body is inlined into that function*/
+class UDPDatagramHandler
+{
+public:
+    UDPDatagramHandler() :
+        m_handler{nullptr, nullptr},
+        m_invoke{nullptr}
+    {
+
+    }
+
+    template <typename Handler>
+    explicit UDPDatagramHandler(Handler handler) :
+        m_handler{new Handler(std::move(handler)), [](void *storedHandler) { delete static_cast<Handler *>(storedHandler); }},
+        m_invoke{[](void *storedHandler, const UDPDatagramView &datagram) { (*static_cast<Handler *>(storedHandler))(datagram); }}
+    {
+
+    }
+
+    void operator()(const UDPDatagramView &datagram) const { this->m_invoke(this->m_handler.get(), datagram); }
+    explicit operator bool() const { return this->m_invoke != nullptr; }
+
+private:
+    std::unique_ptr<void, void (*)(void *)> m_handler;
+    void (*m_invoke)(void *, const UDPDatagramView &);
 };
 
 
 class UDPServer
 {
 friend class UDPDuplex;
+friend class UDPReactor;
+friend class ReceiveOverflowBuffers;
 public:
     UDPServer();
     UDPServer(uint16_t port);
+    UDPServer(uint16_t port, UDPIOEngine ioEngine);
     ~UDPServer();
 
     char readByte();
     UDPDatagram readDatagram();
+    /*Returns the datagram's full size, like recv() with MSG_TRUNC. A return above length means the tail did not fit and was dropped*/
+    ssize_t readDatagramInto(void *buffer, size_t length);
     std::string readLine();
     std::string readUntil(const std::string &until);
     std::string readUntil(const char *until);
     std::string readUntil(char until);
+    /*No copy, see UDPLineView for how long the line stays valid. readLine() and readUntil() are safe from any thread*/
+    UDPLineView readLineView();
+    UDPLineView readUntilView(const std::string &until);
     ssize_t available();
+    bool waitForDatagram(std::chrono::nanoseconds timeout);
     void startListening();
     void stopListening();
     bool isListening() const;
     std::string lineEnding() const;
+    void setStreamingLines(bool streamingLines);
+    bool streamingLines() const;
+    void setReceiveQueueLimit(size_t maximumDatagramCount, size_t maximumByteCount = 0);
+    size_t receiveQueueDatagramLimit() const;
+    size_t receiveQueueByteLimit() const;
+    void setReceiveQueuePolicy(ReceiveQueuePolicy receiveQueuePolicy);
+    ReceiveQueuePolicy receiveQueuePolicy() const;
+    size_t queuedByteCount() const;
+    uint64_t droppedDatagramCount() const;
+    uint64_t droppedByteCount() const;
+    /*The handler runs on the listener thread for every datagram, which is then never queued for the read methods*/
+    template <typename Handler>
+    void setDatagramHandler(Handler handler) { this->installDatagramHandler(UDPDatagramHandler{std::move(handler)}); }
+    void clearDatagramHandler();
+    bool hasDatagramHandler() const;
     bool isEchoServer() const;
     void setIsEchoServer(bool isEchoServer);
+    size_t receiveBatchSize() const;
+    void setReceiveBatchSize(size_t receiveBatchSize);
+    DatagramQueueType datagramQueueType() const;
+    void setDatagramQueueType(DatagramQueueType datagramQueueType, size_t ringBufferCapacity = UDPServer::DEFAULT_RING_BUFFER_CAPACITY);
+    void setDatagramBufferPool(size_t bufferSize, size_t maximumBufferCount);
+    void setReceiveShards(size_t shardCount, bool pinShardsToCpus = false, size_t shardQueueCapacity = UDPServer::DEFAULT_RING_BUFFER_CAPACITY);
+    size_t receiveShardCount() const;
+    void setReceiveTimestamps(bool receiveTimestamps);
+    bool receiveTimestamps() const;
+    void setReceiveGRO(bool receiveGRO);
+    bool receiveGRO() const;
+    DatagramBufferPoolStatistics datagramBufferPoolStatistics() const;
+    UDPIOEngine ioEngine() const;
 
     long timeout() const;
     void setPortNumber(uint16_t portNumber);
@@ -146,19 +373,98 @@ public:
     static uint16_t doUserSelectPortNumber();
     static std::shared_ptr<UDPServer> doUserSelectUDPServer();
 
+    static const std::string DEFAULT_LINE_ENDING;
     static const constexpr uint16_t DEFAULT_PORT_NUMBER{8888};
     static const constexpr unsigned int DEFAULT_TIMEOUT{100};
+    static const constexpr size_t DEFAULT_RECEIVE_BATCH_SIZE{1};
+    static const constexpr size_t MAXIMUM_RECEIVE_BATCH_SIZE{1024};
+    static const constexpr size_t DEFAULT_RING_BUFFER_CAPACITY{4096};
+    static const constexpr size_t DEFAULT_POOL_BUFFER_SIZE{2048};
+    static const constexpr size_t DEFAULT_POOL_BUFFER_COUNT{1024};
+    static const constexpr size_t MAXIMUM_RECEIVE_SHARD_COUNT{64};
+    static const constexpr size_t DEFAULT_GRO_POOL_BUFFER_COUNT{256};
+    static const constexpr UDPIOEngine DEFAULT_IO_ENGINE{UDPIOEngine::Socket};
+    static const constexpr ReceiveQueuePolicy DEFAULT_RECEIVE_QUEUE_POLICY{ReceiveQueuePolicy::DropOldest};
 
 private:
+    static const constexpr size_t CONTROL_BUFFER_SIZE{128};
+
+    struct ReceiveSlot
+    {
+        DatagramBuffer buffer;
+        sockaddr_in address;
+        iovec ioVectors[2];
+        msghdr messageHeader;
+        size_t receivedLength;
+        union {
+            cmsghdr alignment;
+            char buffer[UDPServer::CONTROL_BUFFER_SIZE];
+        } control;
+    };
+
+    struct LineSearch
+    {
+        uint64_t frontGeneration;
+        size_t frontOffset;
+        std::string delimiter;
+        size_t searchedDatagramCount;
+        std::string tail;
+    };
+
+    struct ReceiveShard
+    {
+        int socketNumber;
+        std::unique_ptr<SPSCRingBuffer<UDPDatagram>> datagramRing;
+        std::thread listenerThread;
+    };
+
     struct sockaddr_in m_socketAddress;
     int m_socketNumber;
     bool m_isListening;
     long m_timeout;
     std::deque<UDPDatagram> m_datagramQueue;
+    std::unique_ptr<SPSCRingBuffer<UDPDatagram>> m_datagramRing;
+    //Bytes of m_datagramQueue.front() already taken by readByte(), and bytes put back ahead of it, last one on top
+    size_t m_frontReadOffset;
+    std::string m_putBackBytes;
+    //Bumped whenever the front datagram changes or a queued one is evicted, so a streaming line search knows if it can resume
+    uint64_t m_frontGeneration;
+    bool m_streamingLines;
+    LineSearch m_lineSearch;
+    //Own the storage behind the last UDPLineView until the next line is read
+    UDPDatagram m_viewDatagram;
+    std::string m_assembledLine;
+    //Zero means no limit. DropOldest passes over a partly read front datagram. A ring still holds the listener back once
+    //it reaches its capacity, and drops the newest datagram under DropOldest as well, because only the reading thread may pop it
+    std::atomic<size_t> m_receiveQueueDatagramLimit;
+    std::atomic<size_t> m_receiveQueueByteLimit;
+    std::atomic<ReceiveQueuePolicy> m_receiveQueuePolicy;
+    std::atomic<size_t> m_queuedByteCount;
+    std::atomic<uint64_t> m_droppedDatagramCount;
+    std::atomic<uint64_t> m_droppedByteCount;
+    std::condition_variable m_receiveQueueSpace;
     std::mutex m_ioMutex;
+    std::condition_variable m_datagramAvailable;
+    std::atomic<unsigned int> m_datagramWaiterCount;
     bool m_shutEmDown;
     std::string m_lineEnding;
     bool m_isEchoServer;
+    size_t m_receiveBatchSize;
+    std::shared_ptr<DatagramBufferPool> m_datagramBufferPool;
+    UDPDatagramHandler m_datagramHandler;
+    UDPReactor *m_reactor;
+    std::vector<ReceiveSlot> m_reactorReceiveSlots;
+    std::vector<UDPDatagram> m_reactorReceivedDatagrams;
+#if defined(__linux__)
+    std::vector<mmsghdr> m_reactorMessageHeaders;
+#endif
+    std::vector<ReceiveShard> m_receiveShards;
+    bool m_pinReceiveShards;
+    size_t m_frontShard;
+    size_t m_nextShard;
+    bool m_receiveTimestamps;
+    bool m_receiveGRO;
+    UDPIOEngine m_ioEngine;
 
     void initialize(uint16_t portNumber);
 #if defined(__ANDROID__)
@@ -172,31 +478,104 @@ private:
 
     char readByte(int socketNumber);
     UDPDatagram readDatagram(int socketNumber);
+    ssize_t readDatagramInto(int socketNumber, void *buffer, size_t length);
     std::string readLine(int socketNumber);
     std::string readUntil(int socketNumber, const std::string &until);
     std::string readUntil(int socketNumber, const char *until);
     std::string readUntil(int socketNumber, char until);
+    UDPLineView readLineView(int socketNumber);
+    UDPLineView readUntilView(int socketNumber, const std::string &until);
     ssize_t available(int socketNumber);
+    bool waitForDatagram(int socketNumber, std::chrono::nanoseconds timeout);
     
     std::string peek(int socketNumber);
     char peekByte(int socketNumber);
     UDPDatagram peekDatagram(int socketNumber);
     void asyncDatagramListener(int socketNumber);
-    void syncDatagramListener(int socketNumber);
+    void asyncDatagramListener(int socketNumber, SPSCRingBuffer<UDPDatagram> *datagramRing);
+    void syncDatagramListener(int socketNumber, int flags = 0);
+    void awaitDatagram(int socketNumber);
     void setTimeout(int socketNumber, long timeout);
+    void prepareReceiveSlot(ReceiveSlot &receiveSlot, char *overflowBuffer);
+    void takeReceivedDatagrams(ReceiveSlot &receiveSlot, const char *overflowBuffer, std::vector<UDPDatagram> &receivedDatagrams);
+    void appendReceivedDatagrams(const sockaddr_in &address, DatagramBuffer &&receivedBuffer, msghdr *messageHeader, std::vector<UDPDatagram> &receivedDatagrams);
+    ssize_t receiveDatagram(int socketNumber, ReceiveSlot &receiveSlot, int flags);
+#if defined(__linux__)
+    int receiveDatagramBatch(int socketNumber, std::vector<ReceiveSlot> &receiveSlots, std::vector<mmsghdr> &messageHeaders);
+    void drainDatagrams(int socketNumber, ReceiveOverflowBuffers &overflowBuffers);
+    void takeReceivedMessage(const UDPIoUringMessage &receivedMessage, std::vector<UDPDatagram> &receivedDatagrams);
+    bool ioUringDatagramListener(int socketNumber, SPSCRingBuffer<UDPDatagram> *datagramRing);
+#endif
+    void setReactor(UDPReactor *reactor);
+    void enqueueDatagrams(UDPDatagram *datagrams, size_t count);
+    void enqueueDatagrams(UDPDatagram *datagrams, size_t count, SPSCRingBuffer<UDPDatagram> *datagramRing);
+    void notifyDatagramWaiters();
+    void installDatagramHandler(UDPDatagramHandler &&datagramHandler);
+    bool isReceiveQueueFull(size_t queuedCount, size_t length) const;
+    bool makeReceiveQueueRoom(size_t length, std::unique_lock<std::mutex> &ioMutexLock);
+    bool makeReceiveRingRoom(SPSCRingBuffer<UDPDatagram> *datagramRing, size_t length);
+    void recordDroppedDatagram(size_t length);
+    UDPDatagram *frontDatagram();
+    void popDatagram();
+    UDPDatagram *frontRingDatagram();
+    void popRingDatagram();
+    bool pullRingDatagram();
+    UDPDatagram *frontShardDatagram();
+    bool hasUnreadBytes() const;
+    void settleFrontDatagram();
+    UDPLineView takeFrontBytes(size_t count);
+    void awaitLine(int socketNumber, const std::string &until, std::unique_lock<std::mutex> &ioMutexLock, UDPLineView *line);
+    bool assembleLine(const std::string &until, UDPLineView *line);
+    bool assembleStreamingLine(const std::string &until, UDPLineView *line);
+    int openReusePortSocket();
+    void enableReceiveTimestamps(int socketNumber);
+    void enableReceiveGRO(int socketNumber, bool receiveGRO);
+    void startReceiveShards();
+    void stopReceiveShards();
+    size_t queuedDatagramCount() const;
+    void clearQueuedDatagrams();
 
     void startListening(int socketNumber);
 
-    void respondTo(struct sockaddr_in *address, const std::string &str);
+    void respondTo(struct sockaddr_in *address, const char *data, size_t length);
 
     static const uint16_t BROADCAST;
     static const constexpr size_t RECEIVED_BUFFER_MAX{65535};
     static const constexpr size_t MAXIMUM_BUFFER_SIZE{65535};
+    static const constexpr size_t REACTOR_DRAIN_LIMIT{256};
+    static const constexpr size_t MAXIMUM_GRO_SEGMENTS{128};
 
     static constexpr bool isValidPortNumber(int portNumber);
 
 };
 
+/*The tails of datagrams that outgrow their pooled buffer, one area per receive slot of a listener or reactor thread.
+  Left uninitialized, so only the pages a tail actually lands in are ever touched*/
+class ReceiveOverflowBuffers
+{
+public:
+    ReceiveOverflowBuffers() :
+        m_storage{nullptr},
+        m_slotCount{0}
+    {
+
+    }
+
+    void reserve(size_t slotCount)
+    {
+        if (slotCount > this->m_slotCount) {
+            this->m_storage.reset(new char[slotCount * UDPServer::RECEIVED_BUFFER_MAX]);
+            this->m_slotCount = slotCount;
+        }
+    }
+
+    char *slot(size_t slotIndex) { return this->m_storage.get() + (slotIndex * UDPServer::RECEIVED_BUFFER_MAX); }
+
+private:
+    std::unique_ptr<char[]> m_storage;
+    size_t m_slotCount;
+};
+
 
 class UDPClient
 {
@@ -207,12 +586,20 @@ public:
     UDPClient(const std::string &hostName);
     UDPClient(const std::string &hostName, uint16_t portNumber);
     UDPClient(const std::string &hostName, uint16_t portNumber, uint16_t clientReturnAddressPortNumber);
+    UDPClient(const std::string &hostName, uint16_t portNumber, uint16_t clientReturnAddressPortNumber, UDPIOEngine ioEngine);
     ~UDPClient();
 
     ssize_t writeLine(const char *str);
     ssize_t writeLine(const std::string &str);
+    /*Never blocks on DNS: until hostName is in the endpoint cache these return -1 with errno EAGAIN and resolve it in the background*/
     ssize_t writeLine(const std::string &hostName, uint16_t portNumber, const char *str);
     ssize_t writeLine(const std::string &hostName, uint16_t portNumber, const std::string &str);
+    ssize_t write(const void *data, size_t length);
+    std::vector<ssize_t> writeBatch(const std::vector<std::string> &payloads);
+    std::vector<ssize_t> writeBatch(const std::vector<std::string> &payloads, const std::vector<UDPEndpoint> &destinations);
+    std::vector<ssize_t> writeBatch(const std::string *payloads, size_t count, const UDPEndpoint *destinations = nullptr);
+    std::vector<ssize_t> writeToAll(const std::string &payload, const std::vector<UDPEndpoint> &endpoints);
+    std::vector<ssize_t> writeToAll(const char *data, size_t length, const UDPEndpoint *endpoints, size_t count);
     uint16_t portNumber() const;
     std::string hostName() const;
     uint16_t returnAddressPortNumber() const;
@@ -223,6 +610,42 @@ public:
     void setTimeout(unsigned long int timeout);
     std::string lineEnding() const;
     void setLineEnding(const std::string &lineEnding);
+    UDPIOEngine ioEngine() const;
+    void setSendGSO(bool sendGSO);
+    bool sendGSO() const;
+    void setConnectToDestination(bool connectToDestination);
+    bool connectsToDestination() const;
+    bool isConnected() const;
+    /*Resolves hostName in the background, so the first writeLine() or writeZeroCopy() to it does not miss the cache*/
+    void prefetchEndpoint(const std::string &hostName);
+    void setEndpointTimeToLive(std::chrono::seconds timeToLive);
+    std::chrono::seconds endpointTimeToLive() const;
+    void setSocketPoolSize(size_t socketPoolSize);
+    size_t socketPoolSize() const;
+    void startAsyncSend(size_t sendQueueCapacity = UDPClient::DEFAULT_SEND_QUEUE_CAPACITY);
+    void stopAsyncSend();
+    bool isAsyncSend() const;
+    bool flushSendQueue(std::chrono::nanoseconds timeout);
+    void setSendQueuePolicy(SendQueuePolicy sendQueuePolicy);
+    SendQueuePolicy sendQueuePolicy() const;
+    size_t queuedSendCount() const;
+    uint64_t droppedSendCount() const;
+    uint64_t failedSendCount() const;
+    void setSendRate(double packetsPerSecond, double bytesPerSecond = 0.0);
+    double sendPacketRate() const;
+    double sendByteRate() const;
+    ssize_t writeZeroCopy(const void *data, size_t length, ZeroCopyCompletion completion);
+    ssize_t writeZeroCopy(const std::string &hostName, uint16_t portNumber, const void *data, size_t length, ZeroCopyCompletion completion);
+    void setZeroCopyThreshold(size_t zeroCopyThreshold);
+    size_t zeroCopyThreshold() const;
+    size_t reapZeroCopyCompletions();
+    bool waitForZeroCopyCompletions(std::chrono::nanoseconds timeout);
+    size_t pendingZeroCopyCount() const;
+    uint64_t copiedZeroCopyCount() const;
+    void setLineCoalescing(size_t coalescedDatagramSize, std::chrono::microseconds coalesceDelay = UDPClient::DEFAULT_COALESCE_DELAY);
+    size_t lineCoalescingSize() const;
+    std::chrono::microseconds lineCoalescingDelay() const;
+    void flushCoalescedLines();
 
     void openPort();
     void closePort();
@@ -234,23 +657,117 @@ public:
     static const constexpr uint16_t DEFAULT_RETURN_ADDRESS_PORT_NUMBER{1234};
     static const constexpr unsigned int DEFAULT_TIMEOUT{100};
     static const constexpr unsigned int SEND_RETRY_COUNT{3};
+    static const constexpr size_t SEND_BATCH_SIZE{256};
+    static const constexpr size_t MAXIMUM_GSO_SEGMENTS{64};
+    static const constexpr size_t MAXIMUM_GSO_PAYLOAD{65507};
+    static const constexpr size_t DEFAULT_PATH_MTU{1500};
+    static const constexpr size_t IPV4_UDP_HEADER_SIZE{28};
+    static const constexpr UDPIOEngine DEFAULT_IO_ENGINE{UDPIOEngine::Socket};
+    static const constexpr size_t DEFAULT_SEND_QUEUE_CAPACITY{4096};
+    static const constexpr SendQueuePolicy DEFAULT_SEND_QUEUE_POLICY{SendQueuePolicy::Block};
+    static const constexpr int SEND_QUEUE_WAIT_TIMEOUT{100};
+    static const constexpr size_t DEFAULT_ZERO_COPY_THRESHOLD{16384};
+    static const constexpr int ZERO_COPY_DRAIN_TIMEOUT{1000};
+    static const constexpr size_t DEFAULT_COALESCED_DATAGRAM_SIZE{1472};
+    static const constexpr std::chrono::microseconds DEFAULT_COALESCE_DELAY{1000};
 
     static uint16_t doUserSelectPortNumber();
     static std::string doUserSelectHostName();
     static uint16_t doUserSelectReturnAddressPortNumber();
     static std::shared_ptr<UDPClient> doUserSelectUDPClient();
 private:
+    struct QueuedSend
+    {
+        std::string payload;
+        sockaddr_in destinationAddress;
+    };
+
     struct sockaddr_in m_destinationAddress;
     struct sockaddr_in m_returnAddress;
 
     unsigned int m_timeout;
     int m_udpSocketIndex;
     std::string m_lineEnding;
+    UDPIOEngine m_ioEngine;
+#if defined(__linux__)
+    std::unique_ptr<UDPIoUring> m_ioUring;
+#endif
+    bool m_sendGSO;
+    //A UDP_SEGMENT segment has to fit the path MTU, larger lines take plain sends
+    size_t m_gsoSegmentLimit;
+    bool m_connectToDestination;
+    bool m_isConnected;
+    UDPEndpointCache m_endpointCache;
+    UDPSocketPool m_socketPool;
+    std::unique_ptr<MPMCRingBuffer<QueuedSend>> m_sendQueue;
+    std::atomic<SendQueuePolicy> m_sendQueuePolicy;
+    std::atomic<bool> m_isAsyncSending;
+    std::thread m_sendThread;
+    std::mutex m_sendQueueMutex;
+    std::condition_variable m_sendQueued;
+    std::condition_variable m_sendProgress;
+    std::atomic<bool> m_isSendThreadIdle;
+    std::atomic<unsigned int> m_sendProgressWaiterCount;
+    std::atomic<uint64_t> m_acceptedSendCount;
+    std::atomic<uint64_t> m_completedSendCount;
+    std::atomic<uint64_t> m_droppedSendCount;
+    std::atomic<uint64_t> m_failedSendCount;
+    UDPPacer m_sendPacer;
+    bool m_ownsSocket;
+    UDPZeroCopyTracker m_zeroCopyTracker;
+    size_t m_zeroCopyThreshold;
+    std::atomic<bool> m_isCoalescing;
+    size_t m_coalescedDatagramSize;
+    std::chrono::microseconds m_coalesceDelay;
+    std::string m_coalescedLines;
+    sockaddr_in m_coalescedAddress;
+    std::chrono::steady_clock::time_point m_coalesceDeadline;
+    std::mutex m_coalesceMutex;
+    std::condition_variable m_coalesceCondition;
+    std::thread m_coalesceThread;
+    bool m_stopCoalescing;
+#if defined(__linux__)
+    std::vector<mmsghdr> m_queuedMessageHeaders;
+    std::vector<iovec> m_queuedIoVectors;
+#endif
     
     ssize_t writeByte(char toSend);
     ssize_t writeByte(const std::string &hostName, uint16_t portNumber, char toSend);
+    ssize_t writeLine(const std::string &hostName, uint16_t portNumber, const char *data, size_t length);
+    ssize_t sendLine(const sockaddr_in &destinationAddress, const char *data, size_t length);
+    ssize_t enqueueSend(const sockaddr_in &destinationAddress, const char *data, size_t length, bool appendLineEnding);
+    bool pushQueuedSend(QueuedSend &&queuedSend);
+    void asyncSendLoop();
+    void sendQueuedBatch(std::vector<QueuedSend> &sendBatch);
+    void sendQueuedRun(int socketNumber, const sockaddr_in *destinationAddress, QueuedSend *queuedSends, size_t count);
+    bool retryQueuedSend(int socketNumber, unsigned int &timeoutCount);
+    void notifySendThread();
+    void notifySendProgress();
+    ssize_t sendDatagram(const void *data, size_t length);
+    ssize_t coalesceLine(const sockaddr_in &destinationAddress, const char *data, size_t length);
+    void sendCoalescedLines();
+    void coalesceLoop();
+    ssize_t sendMessage(int socketNumber, const msghdr *messageHeader);
+    ssize_t sendZeroCopy(const sockaddr_in &destinationAddress, const void *data, size_t length, ZeroCopyCompletion &&completion);
+    ssize_t sendDatagram(const sockaddr_in &destinationAddress, iovec *ioVectors, size_t ioVectorCount);
+    ssize_t sendDatagram(int socketNumber, const sockaddr_in *destinationAddress, iovec *ioVectors, size_t ioVectorCount);
+    void writeLineBatch(const std::string *payloads, size_t count, const UDPEndpoint *destinations, ssize_t *results, bool isPaced);
+#if defined(__linux__)
+    void sendDatagramBatch(mmsghdr *messageHeaders, size_t count, ssize_t *results, bool isPaced);
+    size_t pacedMessageCount(const mmsghdr *messageHeaders, size_t count);
+    void writeSegmentedBatch(const std::string *payloads, size_t count, ssize_t *results);
+    ssize_t sendSegmented(const std::string *payloads, size_t count, size_t segmentSize, iovec *ioVectors);
+    size_t pathSegmentLimit() const;
+#endif
     int resolveAddressHelper(const std::string &hostName, int family, const std::string &service, sockaddr_storage* addressPtr);
     void initialize(const std::string &hostName, uint16_t portNumber, uint16_t returnAddressPortNumber);
+    in_addr resolveHostName(const std::string &hostName);
+    bool lookupHostName(const std::string &hostName, in_addr *address);
+    void setDestination(in_addr address, uint16_t portNumber);
+    void connectDestination();
+    void updateConnection();
+    void shareSocket(int socketNumber);
+    sockaddr_in *sendAddress();
 
     
     static constexpr bool isValidPortNumber(int portNumber);
@@ -271,11 +788,18 @@ public:
     ssize_t writeLine(const char *str);
     ssize_t writeLine(const std::string &hostName, uint16_t portNumber, const char *str);
     ssize_t writeLine(const std::string &hostName, uint16_t portNumber, const std::string &str);
+    ssize_t write(const void *data, size_t length);
+    ssize_t writeZeroCopy(const void *data, size_t length, ZeroCopyCompletion completion);
+    std::vector<ssize_t> writeBatch(const std::vector<std::string> &payloads);
+    std::vector<ssize_t> writeBatch(const std::vector<std::string> &payloads, const std::vector<UDPEndpoint> &destinations);
+    std::vector<ssize_t> writeToAll(const std::string &payload, const std::vector<UDPEndpoint> &endpoints);
 
     void setClientHostName(const std::string &hostName);
     void setClientTimeout(long timeout);
     void setClientPortNumber(uint16_t portNumber);
     void setClientReturnAddressPortNumber(uint16_t returnAddressPortNumber);
+    void setClientSendRate(double packetsPerSecond, double bytesPerSecond = 0.0);
+    void setClientLineCoalescing(size_t coalescedDatagramSize, std::chrono::microseconds coalesceDelay = UDPClient::DEFAULT_COALESCE_DELAY);
 
     std::string clientHostName() const;
     long clientTimeout() const;
@@ -285,14 +809,21 @@ public:
     /*Host/Server*/
     char readByte();
     UDPDatagram readDatagram();
+    /*Returns the datagram's full size, like recv() with MSG_TRUNC. A return above length means the tail did not fit and was dropped*/
+    ssize_t readDatagramInto(void *buffer, size_t length);
     std::string readLine();
     std::string readUntil(const std::string &until);
     std::string readUntil(const char *until);
     std::string readUntil(char until);
+    UDPLineView readLineView();
+    UDPLineView readUntilView(const std::string &until);
     ssize_t available();
+    bool waitForDatagram(std::chrono::nanoseconds timeout);
     void startListening();
     void stopListening();
     bool isListening() const;
+    void setStreamingLines(bool streamingLines);
+    bool streamingLines() const;
     void putBack(const UDPDatagram &datagram);
     void putBack(const std::string &str);
     void putBack(const char *str);
@@ -307,6 +838,18 @@ public:
     void flushTX();
 
     long serverTimeout() const;
+    void setServerReceiveQueueLimit(size_t maximumDatagramCount, size_t maximumByteCount = 0);
+    void setServerReceiveQueuePolicy(ReceiveQueuePolicy receiveQueuePolicy);
+    uint64_t droppedDatagramCount() const;
+    uint64_t droppedByteCount() const;
+    template <typename Handler>
+    void setServerDatagramHandler(Handler handler)
+    {
+        if ((this->m_udpObjectType == UDPObjectType::Server) || (this->isDuplex())) {
+            this->m_udpServer->setDatagramHandler(std::move(handler));
+        }
+    }
+    void clearServerDatagramHandler();
     void setServerPortNumber(uint16_t portNumber);
     uint16_t serverPortNumber() const;
     void setServerTimeout(long timeout);
@@ -352,6 +895,7 @@ private:
     int resolveAddressHelper(const std::string &hostName, int family, const std::string &service, sockaddr_storage* addressPtr);
 
     void initialize();
+    bool isDuplex() const;
 
     static constexpr bool isValidPortNumber(int portNumber);
 };
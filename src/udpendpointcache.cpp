@@ -0,0 +1,283 @@
+/***********************************************************************
+*    udpendpointcache.cpp:                                             *
+*    UDPEndpointCache and UDPSocketPool, for UDP fan-out sends         *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a source file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the implementation of a UDPEndpointCache class    *
+*    and of a UDPSocketPool class                                      *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#include "udpendpointcache.h"
+
+#include <algorithm>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <unistd.h>
+
+constexpr std::chrono::seconds UDPEndpointCache::DEFAULT_TIME_TO_LIVE;
+
+UDPEndpointCache::UDPEndpointCache(std::chrono::seconds timeToLive) :
+    m_cachedAddresses{},
+    m_pendingHostNames{},
+    m_timeToLive{timeToLive},
+    m_resolverThread{},
+    m_stopResolver{false}
+{
+
+}
+
+UDPEndpointCache::~UDPEndpointCache()
+{
+    {
+        std::lock_guard<std::mutex> cacheLock{this->m_cacheMutex};
+        this->m_stopResolver = true;
+    }
+    this->m_resolverCondition.notify_all();
+    if (this->m_resolverThread.joinable()) {
+        this->m_resolverThread.join();
+    }
+}
+
+bool UDPEndpointCache::resolve(const std::string &hostName, in_addr *address)
+{
+    std::lock_guard<std::mutex> cacheLock{this->m_cacheMutex};
+    if (this->findCachedAddress(hostName, address)) {
+        return true;
+    }
+    //A name that has never resolved goes to the resolver thread too, so the caller reports a miss instead of waiting on DNS
+    CachedAddress &cachedAddress = this->m_cachedAddresses[hostName];
+    if (std::chrono::steady_clock::now() >= cachedAddress.expiresAt) {
+        this->scheduleRefresh(hostName, cachedAddress);
+    }
+    return false;
+}
+
+bool UDPEndpointCache::resolveNow(const std::string &hostName, in_addr *address)
+{
+    {
+        std::lock_guard<std::mutex> cacheLock{this->m_cacheMutex};
+        if (this->findCachedAddress(hostName, address)) {
+            return true;
+        }
+    }
+    in_addr resolvedAddress{};
+    if (!UDPEndpointCache::resolveHostName(hostName, &resolvedAddress)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> cacheLock{this->m_cacheMutex};
+    CachedAddress &cachedAddress = this->m_cachedAddresses[hostName];
+    cachedAddress.address = resolvedAddress;
+    cachedAddress.expiresAt = std::chrono::steady_clock::now() + this->m_timeToLive;
+    cachedAddress.isResolved = true;
+    *address = resolvedAddress;
+    return true;
+}
+
+bool UDPEndpointCache::findCachedAddress(const std::string &hostName, in_addr *address)
+{
+    auto found = this->m_cachedAddresses.find(hostName);
+    if ((found == this->m_cachedAddresses.end()) || (!found->second.isResolved)) {
+        return false;
+    }
+    if (std::chrono::steady_clock::now() >= found->second.expiresAt) {
+        //An expired address keeps being handed out while the resolver thread looks the name up again
+        this->scheduleRefresh(found->first, found->second);
+    }
+    *address = found->second.address;
+    return true;
+}
+
+void UDPEndpointCache::prefetch(const std::string &hostName)
+{
+    std::lock_guard<std::mutex> cacheLock{this->m_cacheMutex};
+    CachedAddress &cachedAddress = this->m_cachedAddresses[hostName];
+    if ((!cachedAddress.isResolved) || (std::chrono::steady_clock::now() >= cachedAddress.expiresAt)) {
+        this->scheduleRefresh(hostName, cachedAddress);
+    }
+}
+
+void UDPEndpointCache::scheduleRefresh(const std::string &hostName, CachedAddress &cachedAddress)
+{
+    if (cachedAddress.isRefreshing) {
+        return;
+    }
+    cachedAddress.isRefreshing = true;
+    this->m_pendingHostNames.push_back(hostName);
+    if (!this->m_resolverThread.joinable()) {
+        this->m_resolverThread = std::thread{&UDPEndpointCache::resolverLoop, this};
+    }
+    this->m_resolverCondition.notify_one();
+}
+
+void UDPEndpointCache::resolverLoop()
+{
+    std::unique_lock<std::mutex> cacheLock{this->m_cacheMutex};
+    while (true) {
+        this->m_resolverCondition.wait(cacheLock, [this]() { return ((this->m_stopResolver) || (!this->m_pendingHostNames.empty())); });
+        if (this->m_stopResolver) {
+            return;
+        }
+        std::string hostName{std::move(this->m_pendingHostNames.front())};
+        this->m_pendingHostNames.pop_front();
+        cacheLock.unlock();
+        in_addr resolvedAddress{};
+        bool isResolved{UDPEndpointCache::resolveHostName(hostName, &resolvedAddress)};
+        cacheLock.lock();
+        auto found = this->m_cachedAddresses.find(hostName);
+        if (found == this->m_cachedAddresses.end()) {
+            continue;
+        }
+        if (isResolved) {
+            found->second.address = resolvedAddress;
+            found->second.isResolved = true;
+        }
+        //A failed lookup keeps the old address, or the miss, for another time to live instead of retrying on every send
+        found->second.expiresAt = std::chrono::steady_clock::now() + this->m_timeToLive;
+        found->second.isRefreshing = false;
+    }
+}
+
+void UDPEndpointCache::setTimeToLive(std::chrono::seconds timeToLive)
+{
+    std::lock_guard<std::mutex> cacheLock{this->m_cacheMutex};
+    this->m_timeToLive = timeToLive;
+}
+
+std::chrono::seconds UDPEndpointCache::timeToLive() const
+{
+    std::lock_guard<std::mutex> cacheLock{this->m_cacheMutex};
+    return this->m_timeToLive;
+}
+
+size_t UDPEndpointCache::size() const
+{
+    std::lock_guard<std::mutex> cacheLock{this->m_cacheMutex};
+    return this->m_cachedAddresses.size();
+}
+
+void UDPEndpointCache::clear()
+{
+    std::lock_guard<std::mutex> cacheLock{this->m_cacheMutex};
+    this->m_cachedAddresses.clear();
+    this->m_pendingHostNames.clear();
+}
+
+bool UDPEndpointCache::resolveHostName(const std::string &hostName, in_addr *address)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo *resultList{nullptr};
+    if (getaddrinfo(hostName.c_str(), nullptr, &hints, &resultList) != 0) {
+        return false;
+    }
+    *address = reinterpret_cast<sockaddr_in *>(resultList->ai_addr)->sin_addr;
+    freeaddrinfo(resultList);
+    return true;
+}
+
+constexpr size_t UDPSocketPool::DEFAULT_CAPACITY;
+
+UDPSocketPool::UDPSocketPool(size_t capacity) :
+    m_sockets{},
+    m_socketIndex{},
+    m_capacity{capacity},
+    m_socketOptions{}
+{
+
+}
+
+UDPSocketPool::~UDPSocketPool()
+{
+    this->clear();
+}
+
+int UDPSocketPool::connectedSocket(const sockaddr_in &destinationAddress)
+{
+    if (this->m_capacity == 0) {
+        return -1;
+    }
+    uint64_t key{UDPSocketPool::endpointKey(destinationAddress)};
+    auto found = this->m_socketIndex.find(key);
+    if (found != this->m_socketIndex.end()) {
+        this->m_sockets.splice(this->m_sockets.begin(), this->m_sockets, found->second);
+        return found->second->second;
+    }
+    int socketNumber{socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)};
+    if (socketNumber == -1) {
+        return -1;
+    }
+    for (auto &it : this->m_socketOptions) {
+        setsockopt(socketNumber, it.level, it.optionName, &it.value, sizeof(it.value));
+    }
+    if (connect(socketNumber, reinterpret_cast<const sockaddr *>(&destinationAddress), sizeof(destinationAddress)) != 0) {
+        close(socketNumber);
+        return -1;
+    }
+    this->evictTo(this->m_capacity - 1);
+    this->m_sockets.emplace_front(key, socketNumber);
+    this->m_socketIndex.emplace(key, this->m_sockets.begin());
+    return socketNumber;
+}
+
+void UDPSocketPool::setSocketOption(int level, int optionName, unsigned int value)
+{
+    //Remembered so sockets opened later get it too
+    auto found = std::find_if(this->m_socketOptions.begin(), this->m_socketOptions.end(), [level, optionName](const SocketOption &socketOption) {
+        return ((socketOption.level == level) && (socketOption.optionName == optionName));
+    });
+    if (found != this->m_socketOptions.end()) {
+        found->value = value;
+    } else {
+        this->m_socketOptions.push_back(SocketOption{level, optionName, value});
+    }
+    for (auto &it : this->m_sockets) {
+        setsockopt(it.second, level, optionName, &value, sizeof(value));
+    }
+}
+
+void UDPSocketPool::evictTo(size_t socketCount)
+{
+    while (this->m_sockets.size() > socketCount) {
+        close(this->m_sockets.back().second);
+        this->m_socketIndex.erase(this->m_sockets.back().first);
+        this->m_sockets.pop_back();
+    }
+}
+
+void UDPSocketPool::setCapacity(size_t capacity)
+{
+    this->m_capacity = capacity;
+    this->evictTo(capacity);
+}
+
+size_t UDPSocketPool::capacity() const
+{
+    return this->m_capacity;
+}
+
+size_t UDPSocketPool::size() const
+{
+    return this->m_sockets.size();
+}
+
+void UDPSocketPool::clear()
+{
+    this->evictTo(0);
+}
+
+uint64_t UDPSocketPool::endpointKey(const sockaddr_in &destinationAddress)
+{
+    return ((static_cast<uint64_t>(destinationAddress.sin_addr.s_addr) << 16) | destinationAddress.sin_port);
+}
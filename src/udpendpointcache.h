@@ -0,0 +1,122 @@
+/***********************************************************************
+*    udpendpointcache.h:                                               *
+*    UDPEndpointCache and UDPSocketPool, for UDP fan-out sends         *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a header file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the declarations of a UDPEndpointCache class,     *
+*    which keeps resolved host addresses for a time to live and        *
+*    looks up new and expired ones on a background resolver thread,    *
+*    so resolve() never blocks on DNS and resolveNow() is the          *
+*    blocking form for setup paths, and of a UDPSocketPool class,      *
+*    which keeps a least recently used set of sockets that are each    *
+*    connected to one destination                                      *
+*    A UDPSocketPool must only be used from one thread at a time       *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#ifndef TJLUTILS_UDPENDPOINTCACHE_H
+#define TJLUTILS_UDPENDPOINTCACHE_H
+
+#include <string>
+#include <deque>
+#include <list>
+#include <map>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+
+#include <netinet/in.h>
+
+class UDPEndpointCache
+{
+public:
+    explicit UDPEndpointCache(std::chrono::seconds timeToLive = UDPEndpointCache::DEFAULT_TIME_TO_LIVE);
+    UDPEndpointCache(const UDPEndpointCache &) = delete;
+    UDPEndpointCache &operator=(const UDPEndpointCache &) = delete;
+    ~UDPEndpointCache();
+
+    bool resolve(const std::string &hostName, in_addr *address);
+    bool resolveNow(const std::string &hostName, in_addr *address);
+    void prefetch(const std::string &hostName);
+    void setTimeToLive(std::chrono::seconds timeToLive);
+    std::chrono::seconds timeToLive() const;
+    size_t size() const;
+    void clear();
+
+    static const constexpr std::chrono::seconds DEFAULT_TIME_TO_LIVE{30};
+
+private:
+    struct CachedAddress
+    {
+        in_addr address;
+        std::chrono::steady_clock::time_point expiresAt;
+        bool isResolved;
+        bool isRefreshing;
+    };
+
+    std::map<std::string, CachedAddress> m_cachedAddresses;
+    std::deque<std::string> m_pendingHostNames;
+    std::chrono::seconds m_timeToLive;
+    mutable std::mutex m_cacheMutex;
+    std::condition_variable m_resolverCondition;
+    std::thread m_resolverThread;
+    bool m_stopResolver;
+
+    bool findCachedAddress(const std::string &hostName, in_addr *address);
+    void scheduleRefresh(const std::string &hostName, CachedAddress &cachedAddress);
+    void resolverLoop();
+
+    static bool resolveHostName(const std::string &hostName, in_addr *address);
+};
+
+class UDPSocketPool
+{
+public:
+    explicit UDPSocketPool(size_t capacity = UDPSocketPool::DEFAULT_CAPACITY);
+    UDPSocketPool(const UDPSocketPool &) = delete;
+    UDPSocketPool &operator=(const UDPSocketPool &) = delete;
+    ~UDPSocketPool();
+
+    int connectedSocket(const sockaddr_in &destinationAddress);
+    void setSocketOption(int level, int optionName, unsigned int value);
+    void setCapacity(size_t capacity);
+    size_t capacity() const;
+    size_t size() const;
+    void clear();
+
+    static const constexpr size_t DEFAULT_CAPACITY{64};
+
+private:
+    struct SocketOption
+    {
+        int level;
+        int optionName;
+        unsigned int value;
+    };
+
+    //Most recently used at the front, so eviction closes from the back
+    std::list<std::pair<uint64_t, int>> m_sockets;
+    std::unordered_map<uint64_t, std::list<std::pair<uint64_t, int>>::iterator> m_socketIndex;
+    size_t m_capacity;
+    std::vector<SocketOption> m_socketOptions;
+
+    void evictTo(size_t socketCount);
+
+    static uint64_t endpointKey(const sockaddr_in &destinationAddress);
+};
+
+#endif //TJLUTILS_UDPENDPOINTCACHE_H
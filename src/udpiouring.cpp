@@ -0,0 +1,426 @@
+/***********************************************************************
+*    udpiouring.cpp:                                                   *
+*    UDPIoUring, a minimal io_uring ring for UDP receives and sends    *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a source file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the implementation of a UDPIoUring class          *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#include "udpiouring.h"
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <stdexcept>
+#include <string>
+#include <memory.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+
+static int ioUringSetup(unsigned int entryCount, io_uring_params *params)
+{
+    return static_cast<int>(syscall(__NR_io_uring_setup, entryCount, params));
+}
+
+static int ioUringEnter(int ringDescriptor, unsigned int submitCount, unsigned int minimumCompletions, unsigned int flags, void *argument, size_t argumentSize)
+{
+    return static_cast<int>(syscall(__NR_io_uring_enter, ringDescriptor, submitCount, minimumCompletions, flags, argument, argumentSize));
+}
+
+static int ioUringRegister(int ringDescriptor, unsigned int opcode, void *argument, unsigned int argumentCount)
+{
+    return static_cast<int>(syscall(__NR_io_uring_register, ringDescriptor, opcode, argument, argumentCount));
+}
+
+static size_t nextPowerOfTwo(size_t value)
+{
+    size_t powerOfTwo{1};
+    while (powerOfTwo < value) {
+        powerOfTwo <<= 1;
+    }
+    return powerOfTwo;
+}
+
+UDPIoUring::UDPIoUring(unsigned int entryCount) :
+    m_ringDescriptor{-1},
+    m_submissionRing{MAP_FAILED},
+    m_submissionRingSize{0},
+    m_completionRing{MAP_FAILED},
+    m_completionRingSize{0},
+    m_submissionEntries{nullptr},
+    m_submissionEntriesSize{0},
+    m_submissionHead{nullptr},
+    m_submissionTail{nullptr},
+    m_submissionArray{nullptr},
+    m_submissionMask{0},
+    m_submissionEntryCount{0},
+    m_completionHead{nullptr},
+    m_completionTail{nullptr},
+    m_completionMask{0},
+    m_completionEntries{nullptr},
+    m_pendingSubmissions{0},
+    m_bufferRing{nullptr},
+    m_bufferRingSize{0},
+    m_receiveBuffers{nullptr},
+    m_receiveBuffersSize{0},
+    m_receiveBufferSize{0},
+    m_receiveBufferCount{0},
+    m_receiveSocketNumber{-1},
+    m_isReceiveArmed{false},
+    m_isReceiveActive{false},
+    m_receiveHeader{},
+    m_stashedMessages{},
+    m_sendResults{nullptr},
+    m_outstandingSends{0}
+{
+    io_uring_params params{};
+    this->m_ringDescriptor = ioUringSetup(entryCount, &params);
+    if (this->m_ringDescriptor < 0) {
+        throw std::runtime_error("ERROR: UDPIoUring could not set up an io_uring instance (" + std::string{strerror(errno)} + ")");
+    }
+    this->m_submissionRingSize = params.sq_off.array + (params.sq_entries * sizeof(unsigned int));
+    this->m_completionRingSize = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        this->m_submissionRingSize = std::max(this->m_submissionRingSize, this->m_completionRingSize);
+    }
+    this->m_submissionRing = mmap(nullptr, this->m_submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->m_ringDescriptor, IORING_OFF_SQ_RING);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        this->m_completionRing = this->m_submissionRing;
+        this->m_completionRingSize = 0;
+    } else if (this->m_submissionRing != MAP_FAILED) {
+        this->m_completionRing = mmap(nullptr, this->m_completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->m_ringDescriptor, IORING_OFF_CQ_RING);
+    }
+    this->m_submissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void *submissionEntries{MAP_FAILED};
+    if (this->m_completionRing != MAP_FAILED) {
+        submissionEntries = mmap(nullptr, this->m_submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->m_ringDescriptor, IORING_OFF_SQES);
+    }
+    if (submissionEntries == MAP_FAILED) {
+        int mapError{errno};
+        this->releaseReceiveBuffers();
+        if (this->m_completionRing != MAP_FAILED) {
+            munmap(this->m_completionRing, this->m_completionRingSize);
+        }
+        if (this->m_submissionRing != MAP_FAILED) {
+            munmap(this->m_submissionRing, this->m_submissionRingSize);
+        }
+        close(this->m_ringDescriptor);
+        throw std::runtime_error("ERROR: UDPIoUring could not map the io_uring rings (" + std::string{strerror(mapError)} + ")");
+    }
+    this->m_submissionEntries = static_cast<io_uring_sqe *>(submissionEntries);
+
+    char *submissionRing{static_cast<char *>(this->m_submissionRing)};
+    this->m_submissionHead = reinterpret_cast<unsigned int *>(submissionRing + params.sq_off.head);
+    this->m_submissionTail = reinterpret_cast<unsigned int *>(submissionRing + params.sq_off.tail);
+    this->m_submissionArray = reinterpret_cast<unsigned int *>(submissionRing + params.sq_off.array);
+    this->m_submissionMask = *reinterpret_cast<unsigned int *>(submissionRing + params.sq_off.ring_mask);
+    this->m_submissionEntryCount = params.sq_entries;
+    char *completionRing{static_cast<char *>(this->m_completionRing)};
+    this->m_completionHead = reinterpret_cast<unsigned int *>(completionRing + params.cq_off.head);
+    this->m_completionTail = reinterpret_cast<unsigned int *>(completionRing + params.cq_off.tail);
+    this->m_completionMask = *reinterpret_cast<unsigned int *>(completionRing + params.cq_off.ring_mask);
+    this->m_completionEntries = reinterpret_cast<io_uring_cqe *>(completionRing + params.cq_off.cqes);
+}
+
+UDPIoUring::~UDPIoUring()
+{
+    try {
+        this->stopMultishotReceive();
+    } catch (std::exception &e) {
+        (void)e;
+    }
+    //Closing the ring cancels anything still in flight before the buffer memory goes away
+    close(this->m_ringDescriptor);
+    this->releaseReceiveBuffers();
+    munmap(this->m_submissionEntries, this->m_submissionEntriesSize);
+    if (this->m_completionRing != this->m_submissionRing) {
+        munmap(this->m_completionRing, this->m_completionRingSize);
+    }
+    munmap(this->m_submissionRing, this->m_submissionRingSize);
+}
+
+void UDPIoUring::startMultishotReceive(int socketNumber, size_t payloadCapacity, size_t bufferCount)
+{
+    if (this->m_isReceiveActive) {
+        throw std::runtime_error("In UDPIoUring::startMultishotReceive(int, size_t, size_t): A multishot receive is already running on this ring");
+    }
+    if ((payloadCapacity == 0) || (bufferCount == 0) || (bufferCount > UDPIoUring::MAXIMUM_RECEIVE_BUFFER_COUNT)) {
+        throw std::runtime_error("In UDPIoUring::startMultishotReceive(int, size_t, size_t): payload capacity must be greater than 0, and buffer count must be between 1 and " + std::to_string(UDPIoUring::MAXIMUM_RECEIVE_BUFFER_COUNT));
+    }
+    //Each provided buffer holds an io_uring_recvmsg_out header, the source address and the control messages ahead of the payload
+    this->m_receiveHeader = msghdr{};
+    this->m_receiveHeader.msg_namelen = sizeof(sockaddr_in);
+    this->m_receiveHeader.msg_controllen = UDPIoUring::CONTROL_BUFFER_SIZE;
+    size_t headerSize{sizeof(io_uring_recvmsg_out) + this->m_receiveHeader.msg_namelen + this->m_receiveHeader.msg_controllen};
+    this->m_receiveBufferSize = (headerSize + payloadCapacity + 63) & ~static_cast<size_t>(63);
+    this->m_receiveBufferCount = nextPowerOfTwo(bufferCount);
+    this->m_bufferRingSize = this->m_receiveBufferCount * sizeof(io_uring_buf);
+    this->m_receiveBuffersSize = this->m_receiveBufferCount * this->m_receiveBufferSize;
+
+    void *bufferRing{mmap(nullptr, this->m_bufferRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+    void *receiveBuffers{mmap(nullptr, this->m_receiveBuffersSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+    this->m_bufferRing = (bufferRing == MAP_FAILED ? nullptr : static_cast<io_uring_buf_ring *>(bufferRing));
+    this->m_receiveBuffers = (receiveBuffers == MAP_FAILED ? nullptr : static_cast<char *>(receiveBuffers));
+    if ((!this->m_bufferRing) || (!this->m_receiveBuffers)) {
+        this->releaseReceiveBuffers();
+        throw std::runtime_error("ERROR: UDPIoUring could not allocate " + std::to_string(bufferCount) + " receive buffers");
+    }
+    io_uring_buf_reg bufferRegistration{};
+    bufferRegistration.ring_addr = reinterpret_cast<uint64_t>(this->m_bufferRing);
+    bufferRegistration.ring_entries = static_cast<uint32_t>(this->m_receiveBufferCount);
+    bufferRegistration.bgid = UDPIoUring::RECEIVE_BUFFER_GROUP;
+    if (ioUringRegister(this->m_ringDescriptor, IORING_REGISTER_PBUF_RING, &bufferRegistration, 1) < 0) {
+        int registerError{errno};
+        this->releaseReceiveBuffers();
+        throw std::runtime_error("ERROR: UDPIoUring could not register a provided buffer ring (" + std::string{strerror(registerError)} + ")");
+    }
+    std::vector<UDPIoUringMessage> allBuffers(this->m_receiveBufferCount);
+    for (size_t i = 0; i < allBuffers.size(); i++) {
+        allBuffers[i].bufferId = static_cast<uint16_t>(i);
+    }
+    this->recycleReceiveBuffers(allBuffers);
+    this->m_receiveSocketNumber = socketNumber;
+    this->m_isReceiveActive = true;
+    this->armMultishotReceive();
+}
+
+void UDPIoUring::stopMultishotReceive()
+{
+    if (!this->m_isReceiveActive) {
+        return;
+    }
+    this->m_isReceiveActive = false;
+    if (this->m_isReceiveArmed) {
+        io_uring_sqe *submissionEntry{this->nextSubmissionEntry()};
+        submissionEntry->opcode = IORING_OP_ASYNC_CANCEL;
+        submissionEntry->fd = -1;
+        submissionEntry->addr = UDPIoUring::RECEIVE_USER_DATA;
+        submissionEntry->user_data = UDPIoUring::CANCEL_USER_DATA;
+        //The final receive completion, the one without IORING_CQE_F_MORE, means the kernel is done with the buffers
+        while (this->m_isReceiveArmed) {
+            this->enter(1, -1);
+            this->reapCompletions(this->m_stashedMessages);
+        }
+    }
+    this->m_stashedMessages.clear();
+    io_uring_buf_reg bufferRegistration{};
+    bufferRegistration.bgid = UDPIoUring::RECEIVE_BUFFER_GROUP;
+    ioUringRegister(this->m_ringDescriptor, IORING_UNREGISTER_PBUF_RING, &bufferRegistration, 1);
+    this->releaseReceiveBuffers();
+}
+
+bool UDPIoUring::waitForReceives(std::vector<UDPIoUringMessage> &receivedMessages, long timeout)
+{
+    receivedMessages.clear();
+    receivedMessages.swap(this->m_stashedMessages);
+    if ((this->m_isReceiveActive) && (!this->m_isReceiveArmed)) {
+        //The kernel ends a multishot receive once it runs out of provided buffers, so rearm after they are recycled
+        this->armMultishotReceive();
+    }
+    this->reapCompletions(receivedMessages);
+    if (receivedMessages.empty()) {
+        this->enter(1, timeout);
+        this->reapCompletions(receivedMessages);
+    }
+    return !receivedMessages.empty();
+}
+
+void UDPIoUring::recycleReceiveBuffers(const std::vector<UDPIoUringMessage> &receivedMessages)
+{
+    if (!this->m_bufferRing) {
+        return;
+    }
+    //Only this thread produces into the buffer ring, the kernel just consumes from it
+    uint16_t bufferTail{this->m_bufferRing->tail};
+    uint16_t bufferMask{static_cast<uint16_t>(this->m_receiveBufferCount - 1)};
+    //Index from the ring base, in C++ the header's flexible bufs array lands 8 bytes in because its empty struct has size 1
+    io_uring_buf *bufferEntries{reinterpret_cast<io_uring_buf *>(this->m_bufferRing)};
+    for (auto &it : receivedMessages) {
+        io_uring_buf *buffer{&bufferEntries[bufferTail & bufferMask]};
+        buffer->addr = reinterpret_cast<uint64_t>(this->m_receiveBuffers + (it.bufferId * this->m_receiveBufferSize));
+        buffer->len = static_cast<uint32_t>(this->m_receiveBufferSize);
+        buffer->bid = it.bufferId;
+        bufferTail++;
+    }
+    __atomic_store_n(&this->m_bufferRing->tail, bufferTail, __ATOMIC_RELEASE);
+}
+
+void UDPIoUring::sendMessages(int socketNumber, mmsghdr *messageHeaders, size_t count, ssize_t *results)
+{
+    this->m_sendResults = results;
+    size_t sentCount{0};
+    while (sentCount < count) {
+        //One io_uring_enter submits a whole chunk of sends and waits for all of their completions
+        size_t chunkSize{std::min<size_t>(count - sentCount, this->m_submissionEntryCount)};
+        for (size_t i = 0; i < chunkSize; i++) {
+            io_uring_sqe *submissionEntry{this->nextSubmissionEntry()};
+            submissionEntry->opcode = IORING_OP_SENDMSG;
+            submissionEntry->fd = socketNumber;
+            submissionEntry->addr = reinterpret_cast<uint64_t>(&messageHeaders[sentCount + i].msg_hdr);
+            submissionEntry->len = 1;
+            submissionEntry->user_data = sentCount + i;
+        }
+        this->m_outstandingSends += chunkSize;
+        while (this->m_outstandingSends > 0) {
+            this->enter(static_cast<unsigned int>(this->m_outstandingSends), -1);
+            this->reapCompletions(this->m_stashedMessages);
+        }
+        sentCount += chunkSize;
+    }
+    this->m_sendResults = nullptr;
+}
+
+io_uring_sqe *UDPIoUring::nextSubmissionEntry()
+{
+    unsigned int submissionTail{*this->m_submissionTail};
+    if (submissionTail - __atomic_load_n(this->m_submissionHead, __ATOMIC_ACQUIRE) >= this->m_submissionEntryCount) {
+        this->enter(0, -1);
+    }
+    unsigned int entryIndex{submissionTail & this->m_submissionMask};
+    io_uring_sqe *submissionEntry{&this->m_submissionEntries[entryIndex]};
+    memset(submissionEntry, 0, sizeof(io_uring_sqe));
+    this->m_submissionArray[entryIndex] = entryIndex;
+    __atomic_store_n(this->m_submissionTail, submissionTail + 1, __ATOMIC_RELEASE);
+    this->m_pendingSubmissions++;
+    return submissionEntry;
+}
+
+int UDPIoUring::enter(unsigned int minimumCompletions, long timeout)
+{
+    unsigned int flags{minimumCompletions > 0 ? static_cast<unsigned int>(IORING_ENTER_GETEVENTS) : 0};
+    __kernel_timespec waitTime{};
+    io_uring_getevents_arg waitArgument{};
+    void *argument{nullptr};
+    size_t argumentSize{0};
+    if ((minimumCompletions > 0) && (timeout >= 0)) {
+        waitTime.tv_sec = timeout / 1000;
+        waitTime.tv_nsec = (timeout % 1000) * 1000000;
+        waitArgument.sigmask_sz = _NSIG / 8;
+        waitArgument.ts = reinterpret_cast<uint64_t>(&waitTime);
+        argument = &waitArgument;
+        argumentSize = sizeof(waitArgument);
+        flags |= IORING_ENTER_EXT_ARG;
+    }
+    int returnValue{ioUringEnter(this->m_ringDescriptor, this->m_pendingSubmissions, minimumCompletions, flags, argument, argumentSize)};
+    this->m_pendingSubmissions = *this->m_submissionTail - __atomic_load_n(this->m_submissionHead, __ATOMIC_ACQUIRE);
+    if ((returnValue < 0) && (errno != ETIME) && (errno != EINTR) && (errno != EAGAIN) && (errno != EBUSY)) {
+        throw std::runtime_error("ERROR: UDPIoUring io_uring_enter failed (" + std::string{strerror(errno)} + ")");
+    }
+    return returnValue;
+}
+
+void UDPIoUring::armMultishotReceive()
+{
+    io_uring_sqe *submissionEntry{this->nextSubmissionEntry()};
+    submissionEntry->opcode = IORING_OP_RECVMSG;
+    submissionEntry->fd = this->m_receiveSocketNumber;
+    submissionEntry->addr = reinterpret_cast<uint64_t>(&this->m_receiveHeader);
+    submissionEntry->len = 1;
+    submissionEntry->ioprio = IORING_RECV_MULTISHOT;
+    submissionEntry->flags = IOSQE_BUFFER_SELECT;
+    submissionEntry->buf_group = UDPIoUring::RECEIVE_BUFFER_GROUP;
+    submissionEntry->user_data = UDPIoUring::RECEIVE_USER_DATA;
+    this->m_isReceiveArmed = true;
+}
+
+void UDPIoUring::reapCompletions(std::vector<UDPIoUringMessage> &receivedMessages)
+{
+    unsigned int completionHead{*this->m_completionHead};
+    unsigned int completionTail{__atomic_load_n(this->m_completionTail, __ATOMIC_ACQUIRE)};
+    int receiveError{0};
+    for (; completionHead != completionTail; completionHead++) {
+        const io_uring_cqe &completion{this->m_completionEntries[completionHead & this->m_completionMask]};
+        if (completion.user_data == UDPIoUring::CANCEL_USER_DATA) {
+            continue;
+        }
+        if (completion.user_data != UDPIoUring::RECEIVE_USER_DATA) {
+            if (this->m_sendResults) {
+                this->m_sendResults[completion.user_data] = completion.res;
+            }
+            this->m_outstandingSends--;
+            continue;
+        }
+        if (!(completion.flags & IORING_CQE_F_MORE)) {
+            this->m_isReceiveArmed = false;
+        }
+        if ((completion.res < 0) && (completion.res != -ENOBUFS) && (completion.res != -ECANCELED)) {
+            receiveError = -completion.res;
+        }
+        if ((completion.res < 0) || (!(completion.flags & IORING_CQE_F_BUFFER))) {
+            continue;
+        }
+        UDPIoUringMessage receivedMessage{};
+        receivedMessage.bufferId = static_cast<uint16_t>(completion.flags >> IORING_CQE_BUFFER_SHIFT);
+        char *receiveBuffer{this->m_receiveBuffers + (receivedMessage.bufferId * this->m_receiveBufferSize)};
+        io_uring_recvmsg_out receiveHeader{};
+        memcpy(&receiveHeader, receiveBuffer, sizeof(receiveHeader));
+        char *nameArea{receiveBuffer + sizeof(io_uring_recvmsg_out)};
+        char *controlArea{nameArea + this->m_receiveHeader.msg_namelen};
+        char *payloadArea{controlArea + this->m_receiveHeader.msg_controllen};
+        memcpy(&receivedMessage.address, nameArea, std::min<size_t>(receiveHeader.namelen, sizeof(sockaddr_in)));
+        receivedMessage.controlHeader.msg_control = controlArea;
+        receivedMessage.controlHeader.msg_controllen = receiveHeader.controllen;
+        receivedMessage.payload = payloadArea;
+        //A truncated datagram reports its full length, but only what fit in the buffer is there
+        receivedMessage.length = std::min<size_t>(receiveHeader.payloadlen, (receiveBuffer + this->m_receiveBufferSize) - payloadArea);
+        receivedMessages.push_back(receivedMessage);
+    }
+    __atomic_store_n(this->m_completionHead, completionHead, __ATOMIC_RELEASE);
+    if (receiveError != 0) {
+        this->m_isReceiveActive = (this->m_isReceiveArmed);
+        throw std::runtime_error("ERROR: UDPIoUring multishot recvmsg failed (" + std::string{strerror(receiveError)} + ")");
+    }
+}
+
+void UDPIoUring::releaseReceiveBuffers()
+{
+    if (this->m_bufferRing) {
+        munmap(this->m_bufferRing, this->m_bufferRingSize);
+        this->m_bufferRing = nullptr;
+    }
+    if (this->m_receiveBuffers) {
+        munmap(this->m_receiveBuffers, this->m_receiveBuffersSize);
+        this->m_receiveBuffers = nullptr;
+    }
+}
+
+bool UDPIoUring::isSupported()
+{
+    //Multishot recvmsg arrived after provided buffer rings, so probe it on a scratch socket rather than trust either one
+    static const bool ioUringSupported{[]() -> bool {
+        int socketNumber{socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)};
+        if (socketNumber < 0) {
+            return false;
+        }
+        bool isSupported{true};
+        try {
+            UDPIoUring ioUring{8};
+            ioUring.startMultishotReceive(socketNumber, 64, 1);
+            std::vector<UDPIoUringMessage> receivedMessages{};
+            ioUring.waitForReceives(receivedMessages, 0);
+            isSupported = ioUring.m_isReceiveArmed;
+            ioUring.stopMultishotReceive();
+        } catch (std::exception &e) {
+            (void)e;
+            isSupported = false;
+        }
+        close(socketNumber);
+        return isSupported;
+    }()};
+    return ioUringSupported;
+}
+
+#endif //defined(__linux__)
@@ -0,0 +1,118 @@
+/***********************************************************************
+*    udpiouring.h:                                                     *
+*    UDPIoUring, a minimal io_uring ring for UDP receives and sends    *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a header file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the declarations of a UDPIoUring class            *
+*    It talks to the kernel through the raw io_uring syscalls, so      *
+*    there is no dependency on liburing. A ring runs one multishot     *
+*    recvmsg against a provided-buffer ring, and submits sends in      *
+*    batches of SQEs with a single io_uring_enter                      *
+*    A ring must only be used from one thread at a time                *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#ifndef TJLUTILS_UDPIOURING_H
+#define TJLUTILS_UDPIOURING_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+struct UDPIoUringMessage
+{
+    sockaddr_in address;
+    //Points at the control messages inside the provided buffer, so the CMSG macros work on it directly
+    msghdr controlHeader;
+    const char *payload;
+    size_t length;
+    uint16_t bufferId;
+};
+
+class UDPIoUring
+{
+public:
+    explicit UDPIoUring(unsigned int entryCount = UDPIoUring::DEFAULT_ENTRY_COUNT);
+    UDPIoUring(const UDPIoUring &) = delete;
+    UDPIoUring &operator=(const UDPIoUring &) = delete;
+    ~UDPIoUring();
+
+    void startMultishotReceive(int socketNumber, size_t payloadCapacity, size_t bufferCount = UDPIoUring::DEFAULT_RECEIVE_BUFFER_COUNT);
+    void stopMultishotReceive();
+    bool waitForReceives(std::vector<UDPIoUringMessage> &receivedMessages, long timeout);
+    void recycleReceiveBuffers(const std::vector<UDPIoUringMessage> &receivedMessages);
+    void sendMessages(int socketNumber, mmsghdr *messageHeaders, size_t count, ssize_t *results);
+
+    static bool isSupported();
+
+    static const constexpr unsigned int DEFAULT_ENTRY_COUNT{256};
+    static const constexpr size_t DEFAULT_RECEIVE_BUFFER_COUNT{64};
+    static const constexpr size_t MAXIMUM_RECEIVE_BUFFER_COUNT{32768};
+    static const constexpr size_t CONTROL_BUFFER_SIZE{128};
+
+private:
+    int m_ringDescriptor;
+    void *m_submissionRing;
+    size_t m_submissionRingSize;
+    void *m_completionRing;
+    size_t m_completionRingSize;
+    io_uring_sqe *m_submissionEntries;
+    size_t m_submissionEntriesSize;
+    unsigned int *m_submissionHead;
+    unsigned int *m_submissionTail;
+    unsigned int *m_submissionArray;
+    unsigned int m_submissionMask;
+    unsigned int m_submissionEntryCount;
+    unsigned int *m_completionHead;
+    unsigned int *m_completionTail;
+    unsigned int m_completionMask;
+    io_uring_cqe *m_completionEntries;
+    unsigned int m_pendingSubmissions;
+
+    io_uring_buf_ring *m_bufferRing;
+    size_t m_bufferRingSize;
+    char *m_receiveBuffers;
+    size_t m_receiveBuffersSize;
+    size_t m_receiveBufferSize;
+    size_t m_receiveBufferCount;
+    int m_receiveSocketNumber;
+    bool m_isReceiveArmed;
+    bool m_isReceiveActive;
+    msghdr m_receiveHeader;
+    std::vector<UDPIoUringMessage> m_stashedMessages;
+
+    ssize_t *m_sendResults;
+    size_t m_outstandingSends;
+
+    io_uring_sqe *nextSubmissionEntry();
+    int enter(unsigned int minimumCompletions, long timeout);
+    void armMultishotReceive();
+    void reapCompletions(std::vector<UDPIoUringMessage> &receivedMessages);
+    void releaseReceiveBuffers();
+
+    static const constexpr uint64_t RECEIVE_USER_DATA{0xFFFFFFFFFFFFFFFFULL};
+    static const constexpr uint64_t CANCEL_USER_DATA{0xFFFFFFFFFFFFFFFEULL};
+    static const constexpr uint16_t RECEIVE_BUFFER_GROUP{0};
+};
+
+#endif //defined(__linux__)
+
+#endif //TJLUTILS_UDPIOURING_H
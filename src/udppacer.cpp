@@ -0,0 +1,139 @@
+/***********************************************************************
+*    udppacer.cpp:                                                     *
+*    UDPPacer, a token bucket that paces outgoing datagrams            *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a source file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the implementation of a UDPPacer class            *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#include "udppacer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+    #include <time.h>
+#endif
+
+constexpr std::chrono::microseconds UDPPacer::BURST_INTERVAL;
+
+UDPPacer::UDPPacer() :
+    m_isEnabled{false},
+    m_packetsPerSecond{0.0},
+    m_bytesPerSecond{0.0},
+    m_packetTokens{0.0},
+    m_byteTokens{0.0},
+    m_packetCapacity{0.0},
+    m_byteCapacity{0.0},
+    m_lastRefill{std::chrono::steady_clock::now()}
+{
+
+}
+
+void UDPPacer::setRate(double packetsPerSecond, double bytesPerSecond)
+{
+    if ((packetsPerSecond < 0.0) || (bytesPerSecond < 0.0)) {
+        throw std::runtime_error("In UDPPacer::setRate(double, double): send rates must not be negative (0 means unlimited)");
+    }
+    std::lock_guard<std::mutex> pacerLock{this->m_pacerMutex};
+    double burstSeconds{std::chrono::duration<double>(UDPPacer::BURST_INTERVAL).count()};
+    this->m_packetsPerSecond = packetsPerSecond;
+    this->m_bytesPerSecond = bytesPerSecond;
+    //A bucket is never shallower than one message, so low rates send single spaced datagrams
+    this->m_packetCapacity = std::max(1.0, packetsPerSecond * burstSeconds);
+    this->m_byteCapacity = std::max(1.0, bytesPerSecond * burstSeconds);
+    this->m_packetTokens = this->m_packetCapacity;
+    this->m_byteTokens = this->m_byteCapacity;
+    this->m_lastRefill = std::chrono::steady_clock::now();
+    this->m_isEnabled.store((packetsPerSecond > 0.0) || (bytesPerSecond > 0.0));
+}
+
+double UDPPacer::packetsPerSecond() const
+{
+    std::lock_guard<std::mutex> pacerLock{this->m_pacerMutex};
+    return this->m_packetsPerSecond;
+}
+
+double UDPPacer::bytesPerSecond() const
+{
+    std::lock_guard<std::mutex> pacerLock{this->m_pacerMutex};
+    return this->m_bytesPerSecond;
+}
+
+void UDPPacer::refill(std::chrono::steady_clock::time_point now)
+{
+    double elapsedSeconds{std::chrono::duration<double>(now - this->m_lastRefill).count()};
+    if (elapsedSeconds <= 0.0) {
+        return;
+    }
+    this->m_packetTokens = std::min(this->m_packetCapacity, this->m_packetTokens + (elapsedSeconds * this->m_packetsPerSecond));
+    this->m_byteTokens = std::min(this->m_byteCapacity, this->m_byteTokens + (elapsedSeconds * this->m_bytesPerSecond));
+    this->m_lastRefill = now;
+}
+
+double UDPPacer::neededBytes(size_t length) const
+{
+    //A datagram bigger than the bucket only has to wait for a full one, and then drives it negative
+    return std::min(static_cast<double>(length), this->m_byteCapacity);
+}
+
+void UDPPacer::waitForTokens(size_t length)
+{
+    std::chrono::steady_clock::time_point now{std::chrono::steady_clock::now()};
+    this->refill(now);
+    double waitSeconds{0.0};
+    if ((this->m_packetsPerSecond > 0.0) && (this->m_packetTokens < 1.0)) {
+        waitSeconds = (1.0 - this->m_packetTokens) / this->m_packetsPerSecond;
+    }
+    if ((this->m_bytesPerSecond > 0.0) && (this->m_byteTokens < this->neededBytes(length))) {
+        waitSeconds = std::max(waitSeconds, (this->neededBytes(length) - this->m_byteTokens) / this->m_bytesPerSecond);
+    }
+    if (waitSeconds <= 0.0) {
+        return;
+    }
+    std::chrono::steady_clock::time_point deadline{now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(waitSeconds))};
+#if defined(__linux__)
+    //An absolute deadline on the same clock as steady_clock, so oversleeping one wait does not push back the next
+    std::chrono::nanoseconds deadlineNanoseconds{std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch())};
+    timespec deadlineSpec{};
+    deadlineSpec.tv_sec = static_cast<time_t>(deadlineNanoseconds.count() / 1000000000LL);
+    deadlineSpec.tv_nsec = static_cast<long>(deadlineNanoseconds.count() % 1000000000LL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadlineSpec, nullptr) == EINTR) { }
+#else
+    std::this_thread::sleep_until(deadline);
+#endif
+    this->refill(std::max(deadline, std::chrono::steady_clock::now()));
+}
+
+bool UDPPacer::takeTokens(size_t length)
+{
+    if ((this->m_packetsPerSecond > 0.0) && (this->m_packetTokens < 1.0)) {
+        return false;
+    }
+    if ((this->m_bytesPerSecond > 0.0) && (this->m_byteTokens < this->neededBytes(length))) {
+        return false;
+    }
+    this->debitTokens(length);
+    return true;
+}
+
+void UDPPacer::debitTokens(size_t length)
+{
+    if (this->m_packetsPerSecond > 0.0) {
+        this->m_packetTokens -= 1.0;
+    }
+    if (this->m_bytesPerSecond > 0.0) {
+        this->m_byteTokens -= static_cast<double>(length);
+    }
+}
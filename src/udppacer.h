@@ -0,0 +1,79 @@
+/***********************************************************************
+*    udppacer.h:                                                       *
+*    UDPPacer, a token bucket that paces outgoing datagrams            *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a header file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the declarations of a UDPPacer class              *
+*    A pacer holds one bucket of packet tokens and one of byte tokens, *
+*    each refilled at its configured rate and at most BURST_INTERVAL   *
+*    deep. Senders ask it to admit messages, and it sleeps until an    *
+*    absolute deadline whenever the buckets cannot cover the next one  *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#ifndef TJLUTILS_UDPPACER_H
+#define TJLUTILS_UDPPACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+class UDPPacer
+{
+public:
+    UDPPacer();
+    UDPPacer(const UDPPacer &) = delete;
+    UDPPacer &operator=(const UDPPacer &) = delete;
+
+    void setRate(double packetsPerSecond, double bytesPerSecond);
+    double packetsPerSecond() const;
+    double bytesPerSecond() const;
+    bool isEnabled() const { return this->m_isEnabled.load(std::memory_order_relaxed); }
+
+    /*Waits until the first message fits, then admits as many of the rest as the buckets already cover*/
+    template <typename MessageLength>
+    size_t acquire(size_t count, MessageLength messageLength)
+    {
+        if (count == 0) {
+            return 0;
+        }
+        std::lock_guard<std::mutex> pacerLock{this->m_pacerMutex};
+        this->waitForTokens(messageLength(0));
+        this->debitTokens(messageLength(0));
+        size_t admittedCount{1};
+        while ((admittedCount < count) && (this->takeTokens(messageLength(admittedCount)))) {
+            admittedCount++;
+        }
+        return admittedCount;
+    }
+
+    static const constexpr std::chrono::microseconds BURST_INTERVAL{1000};
+
+private:
+    std::atomic<bool> m_isEnabled;
+    mutable std::mutex m_pacerMutex;
+    double m_packetsPerSecond;
+    double m_bytesPerSecond;
+    double m_packetTokens;
+    double m_byteTokens;
+    double m_packetCapacity;
+    double m_byteCapacity;
+    std::chrono::steady_clock::time_point m_lastRefill;
+
+    void refill(std::chrono::steady_clock::time_point now);
+    void waitForTokens(size_t length);
+    bool takeTokens(size_t length);
+    void debitTokens(size_t length);
+    double neededBytes(size_t length) const;
+};
+
+#endif //TJLUTILS_UDPPACER_H
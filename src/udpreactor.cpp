@@ -0,0 +1,195 @@
+/***********************************************************************
+*    udpreactor.cpp:                                                   *
+*    UDPReactor, multiplexes many UDPServer sockets over epoll         *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a source file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the implementation of a UDPReactor class          *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#include "udpreactor.h"
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <stdexcept>
+#include <string>
+#include <memory.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "udpduplex.h"
+
+UDPReactor::UDPReactor(size_t threadCount) :
+    m_epollDescriptor{-1},
+    m_wakeDescriptor{-1},
+    m_shutEmDown{false},
+    m_registrations{},
+    m_threads{}
+{
+    if (threadCount == 0) {
+        throw std::runtime_error("In UDPReactor::UDPReactor(size_t): thread count must be greater than 0");
+    }
+    this->m_epollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+    if (this->m_epollDescriptor == -1) {
+        throw std::runtime_error("ERROR: UDPReactor could not create an epoll instance (" + std::string{strerror(errno)} + ")");
+    }
+    this->m_wakeDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (this->m_wakeDescriptor == -1) {
+        close(this->m_epollDescriptor);
+        throw std::runtime_error("ERROR: UDPReactor could not create a wake descriptor (" + std::string{strerror(errno)} + ")");
+    }
+    //Level triggered and never read, so once signalled it wakes every reactor thread
+    epoll_event wakeEvent{};
+    wakeEvent.events = EPOLLIN;
+    wakeEvent.data.fd = this->m_wakeDescriptor;
+    epoll_ctl(this->m_epollDescriptor, EPOLL_CTL_ADD, this->m_wakeDescriptor, &wakeEvent);
+    for (size_t i = 0; i < threadCount; i++) {
+        this->m_threads.emplace_back(&UDPReactor::run, this);
+    }
+}
+
+UDPReactor::~UDPReactor()
+{
+    this->m_shutEmDown = true;
+    uint64_t wakeValue{1};
+    ssize_t bytesWritten{write(this->m_wakeDescriptor, &wakeValue, sizeof(wakeValue))};
+    (void)bytesWritten;
+    for (auto &it : this->m_threads) {
+        it.join();
+    }
+    std::vector<UDPServer *> attachedServers{};
+    {
+        std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+        for (auto &it : this->m_registrations) {
+            attachedServers.push_back(it.second->server);
+        }
+    }
+    for (auto &it : attachedServers) {
+        this->detach(*it);
+    }
+    close(this->m_wakeDescriptor);
+    close(this->m_epollDescriptor);
+}
+
+void UDPReactor::attach(UDPServer &server)
+{
+    std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+    if (server.m_reactor) {
+        throw std::runtime_error("In UDPReactor::attach(UDPServer &): The server is already attached to a reactor");
+    }
+    if (server.m_isListening) {
+        throw std::runtime_error("In UDPReactor::attach(UDPServer &): The server is already listening on its own thread");
+    }
+    if (!server.m_receiveShards.empty()) {
+        throw std::runtime_error("In UDPReactor::attach(UDPServer &): A server with receive shards runs its own shard listeners");
+    }
+    int socketNumber{server.m_socketNumber};
+    std::shared_ptr<Registration> registration{std::make_shared<Registration>()};
+    registration->server = &server;
+    registration->socketNumber = socketNumber;
+    registration->isAttached = true;
+    registration->isDispatching = false;
+    server.setReactor(this);
+    this->m_registrations[socketNumber] = registration;
+
+    epoll_event socketEvent{};
+    socketEvent.events = EPOLLIN | EPOLLONESHOT;
+    socketEvent.data.fd = socketNumber;
+    if (epoll_ctl(this->m_epollDescriptor, EPOLL_CTL_ADD, socketNumber, &socketEvent) == -1) {
+        this->m_registrations.erase(socketNumber);
+        server.setReactor(nullptr);
+        throw std::runtime_error("ERROR: UDPReactor could not register socket " + std::to_string(socketNumber) + " (" + strerror(errno) + ")");
+    }
+}
+
+void UDPReactor::detach(UDPServer &server)
+{
+    {
+        std::unique_lock<std::mutex> registrationLock{this->m_registrationMutex};
+        if (server.m_reactor != this) {
+            return;
+        }
+        auto found = this->m_registrations.find(server.m_socketNumber);
+        if (found != this->m_registrations.end()) {
+            std::shared_ptr<Registration> registration{found->second};
+            registration->isAttached = false;
+            this->m_registrations.erase(found);
+            epoll_ctl(this->m_epollDescriptor, EPOLL_CTL_DEL, registration->socketNumber, nullptr);
+            server.m_shutEmDown = true;
+            //A reactor thread may still be draining this socket, and the server must outlive that
+            this->m_dispatchFinished.wait(registrationLock, [&registration]() { return !registration->isDispatching; });
+        }
+    }
+    server.setReactor(nullptr);
+}
+
+bool UDPReactor::isAttached(const UDPServer &server) const
+{
+    std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+    return (server.m_reactor == this);
+}
+
+size_t UDPReactor::attachedCount() const
+{
+    std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+    return this->m_registrations.size();
+}
+
+size_t UDPReactor::threadCount() const
+{
+    return this->m_threads.size();
+}
+
+void UDPReactor::run()
+{
+    epoll_event events[UDPReactor::MAXIMUM_EPOLL_EVENTS];
+    ReceiveOverflowBuffers overflowBuffers{};
+    while (!this->m_shutEmDown) {
+        int eventCount{epoll_wait(this->m_epollDescriptor, events, UDPReactor::MAXIMUM_EPOLL_EVENTS, -1)};
+        for (int i = 0; i < eventCount; i++) {
+            if (events[i].data.fd == this->m_wakeDescriptor) {
+                continue;
+            }
+            this->dispatch(events[i].data.fd, overflowBuffers);
+        }
+    }
+}
+
+void UDPReactor::dispatch(int socketNumber, ReceiveOverflowBuffers &overflowBuffers)
+{
+    std::shared_ptr<Registration> registration{nullptr};
+    {
+        std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+        auto found = this->m_registrations.find(socketNumber);
+        if (found == this->m_registrations.end()) {
+            return;
+        }
+        registration = found->second;
+        registration->isDispatching = true;
+    }
+    //EPOLLONESHOT keeps every other reactor thread off this socket until it is rearmed below
+    registration->server->drainDatagrams(socketNumber, overflowBuffers);
+    {
+        std::lock_guard<std::mutex> registrationLock{this->m_registrationMutex};
+        registration->isDispatching = false;
+        if (registration->isAttached) {
+            epoll_event socketEvent{};
+            socketEvent.events = EPOLLIN | EPOLLONESHOT;
+            socketEvent.data.fd = socketNumber;
+            epoll_ctl(this->m_epollDescriptor, EPOLL_CTL_MOD, socketNumber, &socketEvent);
+        }
+    }
+    this->m_dispatchFinished.notify_all();
+}
+
+#endif //defined(__linux__)
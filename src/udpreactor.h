@@ -0,0 +1,77 @@
+/***********************************************************************
+*    udpreactor.h:                                                     *
+*    UDPReactor, multiplexes many UDPServer sockets over epoll         *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a header file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the declarations of a UDPReactor class            *
+*    It registers the sockets of any number of UDPServer objects with  *
+*    a single epoll instance, and a small pool of threads drains each  *
+*    readable socket into its server's datagram queue                  *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#ifndef TJLUTILS_UDPREACTOR_H
+#define TJLUTILS_UDPREACTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+
+class UDPServer;
+class ReceiveOverflowBuffers;
+
+class UDPReactor
+{
+public:
+    explicit UDPReactor(size_t threadCount = UDPReactor::DEFAULT_THREAD_COUNT);
+    UDPReactor(const UDPReactor &) = delete;
+    UDPReactor &operator=(const UDPReactor &) = delete;
+    ~UDPReactor();
+
+    void attach(UDPServer &server);
+    void detach(UDPServer &server);
+    bool isAttached(const UDPServer &server) const;
+    size_t attachedCount() const;
+    size_t threadCount() const;
+
+    static const constexpr size_t DEFAULT_THREAD_COUNT{1};
+    static const constexpr int MAXIMUM_EPOLL_EVENTS{64};
+
+private:
+    struct Registration
+    {
+        UDPServer *server;
+        int socketNumber;
+        bool isAttached;
+        bool isDispatching;
+    };
+
+    int m_epollDescriptor;
+    int m_wakeDescriptor;
+    std::atomic<bool> m_shutEmDown;
+    mutable std::mutex m_registrationMutex;
+    std::condition_variable m_dispatchFinished;
+    std::map<int, std::shared_ptr<Registration>> m_registrations;
+    std::vector<std::thread> m_threads;
+
+    void run();
+    void dispatch(int socketNumber, ReceiveOverflowBuffers &overflowBuffers);
+};
+
+#endif //defined(__linux__)
+
+#endif //TJLUTILS_UDPREACTOR_H
@@ -0,0 +1,223 @@
+/***********************************************************************
+*    udpzerocopy.cpp:                                                  *
+*    UDPZeroCopyTracker, for MSG_ZEROCOPY datagram sends               *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a source file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the implementation of a UDPZeroCopyTracker class  *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#include "udpzerocopy.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <poll.h>
+#include <netinet/in.h>
+
+#if defined(__linux__)
+    #include <linux/errqueue.h>
+#endif
+
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY) && defined(SO_EE_ORIGIN_ZEROCOPY)
+    #define TJLUTILS_UDP_ZEROCOPY 1
+#endif
+
+constexpr std::chrono::milliseconds UDPZeroCopyTracker::DEFAULT_DRAIN_TIMEOUT;
+
+UDPZeroCopyTracker::UDPZeroCopyTracker() :
+    m_socketNumber{-1},
+    m_pendingSends{},
+    m_firstPendingId{0},
+    m_copiedCount{0}
+{
+
+}
+
+bool UDPZeroCopyTracker::isSupported()
+{
+#if defined(TJLUTILS_UDP_ZEROCOPY)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool UDPZeroCopyTracker::enable(int socketNumber)
+{
+    if (this->m_socketNumber == socketNumber) {
+        return true;
+    }
+    //Notification ids restart at 0 on every socket, so the old socket's sends are settled before the new one is tracked
+    this->disable(UDPZeroCopyTracker::DEFAULT_DRAIN_TIMEOUT);
+#if defined(TJLUTILS_UDP_ZEROCOPY)
+    int zeroCopy{1};
+    if (setsockopt(socketNumber, SOL_SOCKET, SO_ZEROCOPY, &zeroCopy, sizeof(zeroCopy)) != 0) {
+        return false;
+    }
+    this->m_socketNumber = socketNumber;
+    return true;
+#else
+    (void)socketNumber;
+    return false;
+#endif
+}
+
+void UDPZeroCopyTracker::disable(std::chrono::nanoseconds drainTimeout)
+{
+    if (this->m_socketNumber == -1) {
+        return;
+    }
+    //Completions the kernel has not reported by the deadline are never called, so their payloads stay with the caller
+    this->waitForCompletions(drainTimeout);
+    this->m_pendingSends.clear();
+    this->m_firstPendingId = 0;
+    this->m_socketNumber = -1;
+}
+
+bool UDPZeroCopyTracker::isEnabled() const
+{
+    return this->m_socketNumber != -1;
+}
+
+ssize_t UDPZeroCopyTracker::send(msghdr *messageHeader, const void *data, size_t length, ZeroCopyCompletion &&completion)
+{
+#if defined(TJLUTILS_UDP_ZEROCOPY)
+    ssize_t bytesWritten{sendmsg(this->m_socketNumber, messageHeader, MSG_ZEROCOPY | MSG_DONTWAIT)};
+    if (bytesWritten != -1) {
+        //The kernel only numbers sends that succeeded, so this one is the next id after everything pending
+        this->m_pendingSends.push_back(PendingSend{data, length, std::move(completion), false});
+    }
+    return bytesWritten;
+#else
+    (void)messageHeader;
+    (void)data;
+    (void)length;
+    (void)completion;
+    errno = EOPNOTSUPP;
+    return -1;
+#endif
+}
+
+size_t UDPZeroCopyTracker::reapCompletions()
+{
+    size_t completedCount{0};
+#if defined(TJLUTILS_UDP_ZEROCOPY)
+    if (this->m_socketNumber == -1) {
+        return 0;
+    }
+    while (!this->m_pendingSends.empty()) {
+        char controlBuffer[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+        msghdr messageHeader{};
+        messageHeader.msg_control = controlBuffer;
+        messageHeader.msg_controllen = sizeof(controlBuffer);
+        if (recvmsg(this->m_socketNumber, &messageHeader, MSG_ERRQUEUE | MSG_DONTWAIT) == -1) {
+            break;
+        }
+        for (cmsghdr *controlMessage = CMSG_FIRSTHDR(&messageHeader); controlMessage != nullptr; controlMessage = CMSG_NXTHDR(&messageHeader, controlMessage)) {
+            if (!(((controlMessage->cmsg_level == SOL_IP) && (controlMessage->cmsg_type == IP_RECVERR)) ||
+                  ((controlMessage->cmsg_level == SOL_IPV6) && (controlMessage->cmsg_type == IPV6_RECVERR)))) {
+                continue;
+            }
+            sock_extended_err extendedError{};
+            memcpy(&extendedError, CMSG_DATA(controlMessage), sizeof(extendedError));
+            if ((extendedError.ee_errno != 0) || (extendedError.ee_origin != SO_EE_ORIGIN_ZEROCOPY)) {
+                continue;
+            }
+            //One notification covers the inclusive id range [ee_info, ee_data]
+            completedCount += this->completeRange(extendedError.ee_info,
+                                                  extendedError.ee_data,
+                                                  (extendedError.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0);
+        }
+    }
+#endif
+    return completedCount;
+}
+
+size_t UDPZeroCopyTracker::completeRange(uint32_t firstId, uint32_t lastId, bool wasCopied)
+{
+    std::vector<PendingSend> completedSends{};
+    //Unsigned differences, so ids that wrapped around 2^32 still land on the right entries
+    uint32_t firstOffset{firstId - this->m_firstPendingId};
+    uint32_t lastOffset{lastId - this->m_firstPendingId};
+    if (firstOffset < this->m_pendingSends.size()) {
+        lastOffset = std::min<uint32_t>(lastOffset, static_cast<uint32_t>(this->m_pendingSends.size() - 1));
+        for (uint32_t offset = firstOffset; offset <= lastOffset; offset++) {
+            PendingSend &pendingSend = this->m_pendingSends[offset];
+            if (pendingSend.isComplete) {
+                continue;
+            }
+            pendingSend.isComplete = true;
+            completedSends.push_back(PendingSend{pendingSend.data, pendingSend.length, std::move(pendingSend.completion), true});
+        }
+    }
+    while ((!this->m_pendingSends.empty()) && (this->m_pendingSends.front().isComplete)) {
+        this->m_pendingSends.pop_front();
+        this->m_firstPendingId++;
+    }
+    if (wasCopied) {
+        this->m_copiedCount += completedSends.size();
+    }
+    //Completions run last, so one that sends again sees a consistent tracker
+    for (auto &it : completedSends) {
+        if (it.completion) {
+            it.completion(it.data, it.length, wasCopied);
+        }
+    }
+    return completedSends.size();
+}
+
+bool UDPZeroCopyTracker::waitForCompletions(std::chrono::nanoseconds timeout)
+{
+    std::chrono::steady_clock::time_point deadline{std::chrono::steady_clock::now() + timeout};
+    this->reapCompletions();
+    while (!this->m_pendingSends.empty()) {
+        std::chrono::steady_clock::time_point now{std::chrono::steady_clock::now()};
+        if (now >= deadline) {
+            return false;
+        }
+        //The error queue raises POLLERR even though no events are asked for
+        pollfd pollDescriptor{};
+        pollDescriptor.fd = this->m_socketNumber;
+        pollDescriptor.events = 0;
+        int pollTimeout{static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count()) + 1};
+        int pollResult{poll(&pollDescriptor, 1, pollTimeout)};
+        if ((pollResult < 0) && (errno != EINTR)) {
+            return false;
+        }
+        if ((this->reapCompletions() == 0) && (pollResult > 0)) {
+            //A pending ICMP error also raises POLLERR, and stays raised until it is read
+            int socketError{0};
+            socklen_t socketErrorLength{sizeof(socketError)};
+            getsockopt(this->m_socketNumber, SOL_SOCKET, SO_ERROR, &socketError, &socketErrorLength);
+        }
+    }
+    return true;
+}
+
+size_t UDPZeroCopyTracker::pendingCount() const
+{
+    size_t pendingCount{0};
+    for (auto &it : this->m_pendingSends) {
+        if (!it.isComplete) {
+            pendingCount++;
+        }
+    }
+    return pendingCount;
+}
+
+uint64_t UDPZeroCopyTracker::copiedCount() const
+{
+    return this->m_copiedCount;
+}
@@ -0,0 +1,76 @@
+/***********************************************************************
+*    udpzerocopy.h:                                                    *
+*    UDPZeroCopyTracker, for MSG_ZEROCOPY datagram sends               *
+*    Copyright (c) 2017 Tyler Lewis                                    *
+************************************************************************
+*    This is a header file for tjlutils:                               *
+*    https://github.serial/tlewiscpp/tjlutils                         *
+*    This file may be distributed with the entire tjlutils library,    *
+*    but may also be distributed as a standalone file                  *
+*    The source code is released under the GNU LGPL                    *
+*    This file holds the declarations of a UDPZeroCopyTracker class    *
+*    A tracker enables SO_ZEROCOPY on one socket, sends datagrams with *
+*    MSG_ZEROCOPY and keeps the caller's completion for each one until *
+*    the kernel reports on the socket error queue that it no longer    *
+*    references the payload pages                                      *
+*    A UDPZeroCopyTracker must only be used from one thread at a time  *
+*                                                                      *
+*    You should have received a copy of the GNU Lesser General         *
+*    Public license along with tjlutils                                *
+*    If not, see <http://www.gnu.org/licenses/>                        *
+***********************************************************************/
+
+#ifndef TJLUTILS_UDPZEROCOPY_H
+#define TJLUTILS_UDPZEROCOPY_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+
+/*Called once the payload may be reused or freed, wasCopied is true when it was copied into the kernel after all*/
+using ZeroCopyCompletion = std::function<void(const void *data, size_t length, bool wasCopied)>;
+
+class UDPZeroCopyTracker
+{
+public:
+    UDPZeroCopyTracker();
+    UDPZeroCopyTracker(const UDPZeroCopyTracker &) = delete;
+    UDPZeroCopyTracker &operator=(const UDPZeroCopyTracker &) = delete;
+
+    bool enable(int socketNumber);
+    void disable(std::chrono::nanoseconds drainTimeout);
+    bool isEnabled() const;
+    ssize_t send(msghdr *messageHeader, const void *data, size_t length, ZeroCopyCompletion &&completion);
+    size_t reapCompletions();
+    bool waitForCompletions(std::chrono::nanoseconds timeout);
+    size_t pendingCount() const;
+    uint64_t copiedCount() const;
+
+    static bool isSupported();
+
+    static const constexpr std::chrono::milliseconds DEFAULT_DRAIN_TIMEOUT{1000};
+
+private:
+    struct PendingSend
+    {
+        const void *data;
+        size_t length;
+        ZeroCopyCompletion completion;
+        bool isComplete;
+    };
+
+    int m_socketNumber;
+    //Indexed by notification id minus m_firstPendingId, because the kernel numbers zero-copy sends on a socket consecutively
+    std::deque<PendingSend> m_pendingSends;
+    uint32_t m_firstPendingId;
+    uint64_t m_copiedCount;
+
+    size_t completeRange(uint32_t firstId, uint32_t lastId, bool wasCopied);
+};
+
+#endif //TJLUTILS_UDPZEROCOPY_H